@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "array_kernels.h"
+
+namespace natiflect {
+
+    CriticalSection::CriticalSection(JNIEnv *env, const vector<CriticalArray> &arrays) : arrays_(arrays) {
+        env_ = env;
+        is_copy_ = false;
+        elements_.reserve(arrays_.size());
+        for (size_t i = 0; i < arrays_.size(); i++) {
+            jboolean is_copy = JNI_FALSE;
+            void *elements = env_->GetPrimitiveArrayCritical(arrays_[i].array, &is_copy);
+            if (!elements) {
+                Release();
+                env_->ExceptionClear();
+                throw AccessException("Cannot pin the primitive array.");
+            }
+            elements_.push_back(elements);
+            is_copy_ = is_copy_ || is_copy;
+        }
+    }
+
+    CriticalSection::~CriticalSection() {
+        Release();
+    }
+
+    void CriticalSection::Release() {
+        while (!elements_.empty()) {
+            size_t i = elements_.size() - 1;
+            env_->ReleasePrimitiveArrayCritical(arrays_[i].array, elements_[i], arrays_[i].read_only ? JNI_ABORT : 0);
+            elements_.pop_back();
+        }
+    }
+
+    jsize GetCheckedLength(JNIEnv *env, jarray src, jarray dst) {
+        jsize length = env->GetArrayLength(src);
+        if (env->GetArrayLength(dst) < length) {
+            throw AccessException("The destination array is shorter than the source array.");
+        }
+        return length;
+    }
+}
@@ -0,0 +1,267 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_ARRAY_KERNELS_H
+#define NATIFLECT_ARRAY_KERNELS_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+#include "exception.h"
+#include "array_traits.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // Number of elements processed per critical region, so that a long kernel never holds off the GC
+    // for the whole array.
+    const jsize kCriticalChunkSize = 1 << 16;
+
+    struct CriticalArray {
+        CriticalArray(jarray array, bool read_only = false) : array(array), read_only(read_only) { };
+
+        jarray array;
+        // Read-only arrays are released with JNI_ABORT, so a VM that copies never copies them back.
+        bool read_only;
+    };
+
+    // Pins several primitive arrays together with GetPrimitiveArrayCritical, and releases them
+    // in reverse order. No JNI function may be called while a section is alive.
+    class CriticalSection {
+    public:
+        CriticalSection(JNIEnv *env, const vector<CriticalArray> &arrays);
+
+        ~CriticalSection();
+
+        void *const *GetElements() const { return elements_.data(); };
+
+        // Whether the VM handed out a copy of any array instead of pinning it.
+        bool IsCopy() const { return is_copy_; };
+
+        void Release();
+
+    private:
+        CriticalSection(const CriticalSection &);
+
+        CriticalSection &operator=(const CriticalSection &);
+
+        JNIEnv *env_;
+        vector<CriticalArray> arrays_;
+        vector<void *> elements_;
+        bool is_copy_;
+    };
+
+    // Calls fn(void *const *elements, jsize begin, jsize end) over [0, length) in chunks of chunk_size
+    // elements, with all arrays pinned during each call. elements[i] points to the first element of
+    // arrays[i]. fn must not call JNI or block. If the VM copies arrays instead of pinning them,
+    // re-pinning would copy them again per chunk, so the remaining elements are processed at once.
+    template<typename F>
+    void RunCritical(JNIEnv *env, const vector<CriticalArray> &arrays, jsize length, F fn,
+                     jsize chunk_size = kCriticalChunkSize) {
+        jsize begin = 0;
+        while (begin < length) {
+            CriticalSection section(env, arrays);
+            jsize end = (section.IsCopy() || length - begin <= chunk_size) ? length : begin + chunk_size;
+            fn(section.GetElements(), begin, end);
+            begin = end;
+        }
+    }
+
+    jsize GetCheckedLength(JNIEnv *env, jarray src, jarray dst);
+
+#pragma mark - Element Kernels
+
+    // Plain loops over restrict-qualified pointers, written so that compilers vectorize them.
+
+    template<typename From, typename To>
+    void ConvertElements(const From *__restrict src, To *__restrict dst, jsize count) {
+        for (jsize i = 0; i < count; i++) {
+            dst[i] = (To) src[i];
+        }
+    }
+
+    template<typename E>
+    void ScaleElements(E *__restrict elements, E factor, jsize count) {
+        for (jsize i = 0; i < count; i++) {
+            elements[i] = (E) (elements[i] * factor);
+        }
+    }
+
+    template<typename E>
+    struct SumTraits {
+        typedef jlong Type;
+    };
+
+    template<>
+    struct SumTraits<jfloat> {
+        typedef jdouble Type;
+    };
+
+    template<>
+    struct SumTraits<jdouble> {
+        typedef jdouble Type;
+    };
+
+    template<typename E>
+    typename SumTraits<E>::Type SumElements(const E *__restrict elements, jsize count) {
+        // Four independent accumulators let floating point sums vectorize without reassociation.
+        typedef typename SumTraits<E>::Type S;
+        S sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        jsize i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sum0 += elements[i];
+            sum1 += elements[i + 1];
+            sum2 += elements[i + 2];
+            sum3 += elements[i + 3];
+        }
+        for (; i < count; i++) {
+            sum0 += elements[i];
+        }
+        return (sum0 + sum1) + (sum2 + sum3);
+    }
+
+    template<typename E>
+    void MinMaxElements(const E *__restrict elements, jsize count, E *min, E *max) {
+        E lo = *min, hi = *max;
+        for (jsize i = 0; i < count; i++) {
+            E e = elements[i];
+            lo = e < lo ? e : lo;
+            hi = e > hi ? e : hi;
+        }
+        *min = lo;
+        *max = hi;
+    }
+
+    template<size_t Size>
+    struct UnsignedOfSize;
+
+    template<>
+    struct UnsignedOfSize<2> {
+        typedef uint16_t Type;
+
+        static uint16_t Swap(uint16_t x) { return (uint16_t) ((x << 8) | (x >> 8)); };
+    };
+
+    template<>
+    struct UnsignedOfSize<4> {
+        typedef uint32_t Type;
+
+        static uint32_t Swap(uint32_t x) {
+            return ((x & 0xFF000000u) >> 24) | ((x & 0x00FF0000u) >> 8)
+                   | ((x & 0x0000FF00u) << 8) | ((x & 0x000000FFu) << 24);
+        };
+    };
+
+    template<>
+    struct UnsignedOfSize<8> {
+        typedef uint64_t Type;
+
+        static uint64_t Swap(uint64_t x) {
+            return ((uint64_t) UnsignedOfSize<4>::Swap((uint32_t) x) << 32)
+                   | UnsignedOfSize<4>::Swap((uint32_t) (x >> 32));
+        };
+    };
+
+    template<typename E>
+    void ByteSwapElements(E *__restrict elements, jsize count) {
+        typedef UnsignedOfSize<sizeof(E)> U;
+        for (jsize i = 0; i < count; i++) {
+            typename U::Type x;
+            memcpy(&x, &elements[i], sizeof(E));
+            x = U::Swap(x);
+            memcpy(&elements[i], &x, sizeof(E));
+        }
+    }
+
+#pragma mark - Array Kernels
+
+    template<typename From, typename To>
+    void ConvertArray(JNIEnv *env, typename ArrayTraits<From>::ArrayType src,
+                      typename ArrayTraits<To>::ArrayType dst) {
+        vector<CriticalArray> arrays;
+        arrays.push_back(CriticalArray(src, true));
+        arrays.push_back(CriticalArray(dst));
+        RunCritical(env, arrays, GetCheckedLength(env, src, dst), [](void *const *elements, jsize begin, jsize end) {
+            ConvertElements((const From *) elements[0] + begin, (To *) elements[1] + begin, end - begin);
+        });
+    }
+
+    template<typename E>
+    void CopyArray(JNIEnv *env, typename ArrayTraits<E>::ArrayType src, typename ArrayTraits<E>::ArrayType dst) {
+        vector<CriticalArray> arrays;
+        arrays.push_back(CriticalArray(src, true));
+        arrays.push_back(CriticalArray(dst));
+        RunCritical(env, arrays, GetCheckedLength(env, src, dst), [](void *const *elements, jsize begin, jsize end) {
+            memcpy((E *) elements[1] + begin, (const E *) elements[0] + begin, (end - begin) * sizeof(E));
+        });
+    }
+
+    template<typename E>
+    void ScaleArray(JNIEnv *env, typename ArrayTraits<E>::ArrayType array, E factor) {
+        vector<CriticalArray> arrays(1, CriticalArray(array));
+        RunCritical(env, arrays, env->GetArrayLength(array), [factor](void *const *elements, jsize begin, jsize end) {
+            ScaleElements((E *) elements[0] + begin, factor, end - begin);
+        });
+    }
+
+    template<typename E>
+    typename SumTraits<E>::Type SumArray(JNIEnv *env, typename ArrayTraits<E>::ArrayType array) {
+        typename SumTraits<E>::Type sum = 0;
+        vector<CriticalArray> arrays(1, CriticalArray(array, true));
+        RunCritical(env, arrays, env->GetArrayLength(array), [&sum](void *const *elements, jsize begin, jsize end) {
+            sum += SumElements((const E *) elements[0] + begin, end - begin);
+        });
+        return sum;
+    }
+
+    // Returns false, leaving min and max untouched, if the array is empty.
+    template<typename E>
+    bool MinMaxArray(JNIEnv *env, typename ArrayTraits<E>::ArrayType array, E *min, E *max) {
+        jsize length = env->GetArrayLength(array);
+        if (length == 0) {
+            return false;
+        }
+        bool first = true;
+        vector<CriticalArray> arrays(1, CriticalArray(array, true));
+        RunCritical(env, arrays, length, [&](void *const *elements, jsize begin, jsize end) {
+            const E *chunk = (const E *) elements[0] + begin;
+            if (first) {
+                *min = *max = chunk[0];
+                first = false;
+            }
+            MinMaxElements(chunk, end - begin, min, max);
+        });
+        return true;
+    }
+
+    template<typename E>
+    void ByteSwapArray(JNIEnv *env, typename ArrayTraits<E>::ArrayType array) {
+        vector<CriticalArray> arrays(1, CriticalArray(array));
+        RunCritical(env, arrays, env->GetArrayLength(array), [](void *const *elements, jsize begin, jsize end) {
+            ByteSwapElements((E *) elements[0] + begin, end - begin);
+        });
+    }
+}
+
+#endif //NATIFLECT_ARRAY_KERNELS_H
@@ -0,0 +1,186 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_ARRAY_TRAITS_H
+#define NATIFLECT_ARRAY_TRAITS_H
+
+#include <jni.h>
+
+namespace natiflect {
+
+    // Maps a JNI primitive type to its array type and the matching array functions of JNIEnv.
+    template<typename E>
+    struct ArrayTraits;
+
+    template<>
+    struct ArrayTraits<jboolean> {
+        typedef jbooleanArray ArrayType;
+
+        static const char kSig = 'Z';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewBooleanArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jboolean *buf) {
+            env->GetBooleanArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jboolean *buf) {
+            env->SetBooleanArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jbyte> {
+        typedef jbyteArray ArrayType;
+
+        static const char kSig = 'B';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewByteArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jbyte *buf) {
+            env->GetByteArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jbyte *buf) {
+            env->SetByteArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jchar> {
+        typedef jcharArray ArrayType;
+
+        static const char kSig = 'C';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewCharArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jchar *buf) {
+            env->GetCharArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jchar *buf) {
+            env->SetCharArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jshort> {
+        typedef jshortArray ArrayType;
+
+        static const char kSig = 'S';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewShortArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jshort *buf) {
+            env->GetShortArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jshort *buf) {
+            env->SetShortArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jint> {
+        typedef jintArray ArrayType;
+
+        static const char kSig = 'I';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewIntArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jint *buf) {
+            env->GetIntArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jint *buf) {
+            env->SetIntArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jlong> {
+        typedef jlongArray ArrayType;
+
+        static const char kSig = 'J';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewLongArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jlong *buf) {
+            env->GetLongArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jlong *buf) {
+            env->SetLongArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jfloat> {
+        typedef jfloatArray ArrayType;
+
+        static const char kSig = 'F';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewFloatArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jfloat *buf) {
+            env->GetFloatArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jfloat *buf) {
+            env->SetFloatArrayRegion(array, start, length, buf);
+        }
+    };
+
+    template<>
+    struct ArrayTraits<jdouble> {
+        typedef jdoubleArray ArrayType;
+
+        static const char kSig = 'D';
+
+        static ArrayType NewArray(JNIEnv *env, jsize length) {
+            return env->NewDoubleArray(length);
+        }
+
+        static void GetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, jdouble *buf) {
+            env->GetDoubleArrayRegion(array, start, length, buf);
+        }
+
+        static void SetRegion(JNIEnv *env, ArrayType array, jsize start, jsize length, const jdouble *buf) {
+            env->SetDoubleArrayRegion(array, start, length, buf);
+        }
+    };
+}
+
+#endif //NATIFLECT_ARRAY_TRAITS_H
@@ -0,0 +1,249 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Measures how natiflect scales with native threads on an embedded JVM: throughput, tail latency and
+// scaling efficiency of Class/Object<T> operations, plus the cost of attaching threads.
+//
+// Usage: natiflect_concurrency_bench [max_threads] [seconds_per_step] [read|write|call|mixed|all]
+// The JVM library is found as described for VmOptions::library_path, e.g. through JAVA_HOME.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "natiflect.h"
+
+using namespace natiflect;
+
+namespace {
+
+    // Every this many operations, one operation's latency is sampled.
+    const int kSampleInterval = 8;
+    // Operations per local frame.
+    const int kFrameSize = 64;
+
+    enum Workload {
+        kRead,
+        kWrite,
+        kCall,
+        kMixed
+    };
+
+    const char *const kWorkloadNames[] = {"read", "write", "call", "mixed"};
+
+    struct ThreadResult {
+        uint64_t ops;
+        double attach_us;
+        vector<int64_t> latencies_ns;
+    };
+
+    struct StepResult {
+        double ops_per_sec;
+        double p50_us;
+        double p99_us;
+        double p999_us;
+        double attach_us;
+    };
+
+    int64_t NowNanos() {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void RunOperation(JNIEnv *env, Workload workload, Object<jobject> &counter, uint64_t i) {
+        Workload op = workload == kMixed ? (Workload) (i % 3) : workload;
+        switch (op) {
+            case kRead: {
+                // Instance field read, plus a static read through a class looked up by name.
+                counter.Get_I("value");
+                if (i % 16 == 0) {
+                    Class integer(env, "java/lang/Integer");
+                    integer.GetStatic_I("MAX_VALUE");
+                }
+                break;
+            }
+            case kWrite: {
+                counter.Set_I("value", (jint) i);
+                if (i % 16 == 0) {
+                    // Global reference churn.
+                    jobject global = env->NewGlobalRef(counter.GetValue());
+                    env->DeleteGlobalRef(global);
+                }
+                break;
+            }
+            default: {
+                counter.Call_I("incrementAndGet");
+                if (i % 16 == 0) {
+                    Class math(env, "java/lang/Math");
+                    math.CallStatic_I("max", "(II)I", (jint) i, 7);
+                }
+                break;
+            }
+        }
+    }
+
+    void RunThread(JavaVM *vm, Workload workload, atomic<bool> *start, atomic<bool> *stop, ThreadResult *result) {
+        JNIEnv *env = NULL;
+        int64_t attach_start = NowNanos();
+        if (vm->AttachCurrentThread((void **) &env, NULL) != JNI_OK) {
+            fprintf(stderr, "Cannot attach thread.\n");
+            exit(1);
+        }
+        result->attach_us = (NowNanos() - attach_start) / 1e3;
+        result->ops = 0;
+        result->latencies_ns.reserve(1 << 20);
+
+        try {
+            env->PushLocalFrame(16);
+            Class clz(env, "java/util/concurrent/atomic/AtomicInteger");
+            Object<jobject> counter(env, clz.NewInstance());
+
+            while (!start->load()) {
+                this_thread::yield();
+            }
+            uint64_t i = 0;
+            while (!stop->load(memory_order_relaxed)) {
+                env->PushLocalFrame(kFrameSize * 4);
+                for (int j = 0; j < kFrameSize; j++, i++) {
+                    if (i % kSampleInterval == 0) {
+                        int64_t op_start = NowNanos();
+                        RunOperation(env, workload, counter, i);
+                        result->latencies_ns.push_back(NowNanos() - op_start);
+                    } else {
+                        RunOperation(env, workload, counter, i);
+                    }
+                }
+                env->PopLocalFrame(NULL);
+            }
+            result->ops = i;
+            env->PopLocalFrame(NULL);
+        } catch (const Exception &e) {
+            fprintf(stderr, "%s\n", e.msg.c_str());
+            exit(1);
+        }
+        vm->DetachCurrentThread();
+    }
+
+    double Percentile(vector<int64_t> &values, double p) {
+        if (values.empty()) {
+            return 0;
+        }
+        size_t n = (size_t) (p * (values.size() - 1));
+        nth_element(values.begin(), values.begin() + n, values.end());
+        return values[n] / 1e3;
+    }
+
+    StepResult RunStep(JavaVM *vm, Workload workload, int threads, double seconds) {
+        atomic<bool> start(false);
+        atomic<bool> stop(false);
+        vector<ThreadResult> results((size_t) threads);
+        vector<thread> workers;
+        for (int i = 0; i < threads; i++) {
+            workers.push_back(thread(RunThread, vm, workload, &start, &stop, &results[i]));
+        }
+        // Let the threads attach and set up before the clock starts.
+        this_thread::sleep_for(chrono::milliseconds(100));
+        int64_t begin = NowNanos();
+        start.store(true);
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        stop.store(true);
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+        int64_t elapsed = NowNanos() - begin;
+
+        StepResult step;
+        uint64_t ops = 0;
+        double attach_us = 0;
+        vector<int64_t> latencies;
+        for (size_t i = 0; i < results.size(); i++) {
+            ops += results[i].ops;
+            attach_us += results[i].attach_us;
+            latencies.insert(latencies.end(), results[i].latencies_ns.begin(), results[i].latencies_ns.end());
+        }
+        step.ops_per_sec = ops / (elapsed / 1e9);
+        step.attach_us = attach_us / threads;
+        step.p50_us = Percentile(latencies, 0.5);
+        step.p99_us = Percentile(latencies, 0.99);
+        step.p999_us = Percentile(latencies, 0.999);
+        return step;
+    }
+}
+
+int main(int argc, char **argv) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int) thread::hardware_concurrency();
+    double seconds = argc > 2 ? atof(argv[2]) : 2;
+    const char *workload_name = argc > 3 ? argv[3] : "all";
+    if (max_threads <= 0) {
+        max_threads = 1;
+    }
+
+    vector<Workload> workloads;
+    for (int i = kRead; i <= kMixed; i++) {
+        if (strcmp(workload_name, "all") == 0 || strcmp(workload_name, kWorkloadNames[i]) == 0) {
+            workloads.push_back((Workload) i);
+        }
+    }
+    if (workloads.empty()) {
+        fprintf(stderr, "Unknown workload \"%s\".\n", workload_name);
+        return 1;
+    }
+
+    try {
+        VmOptions options;
+        options.max_heap = "512m";
+        Vm vm(options);
+        vm.GetEnv();
+
+        printf("%-8s %8s %14s %10s %10s %10s %11s %10s\n",
+               "workload", "threads", "ops/s", "p50(us)", "p99(us)", "p99.9(us)", "efficiency", "attach(us)");
+        for (size_t w = 0; w < workloads.size(); w++) {
+            // Unmeasured run so that the JIT and natiflect's caches are warm.
+            RunStep(vm.GetJavaVM(), workloads[w], 1, seconds / 2);
+            double single = 0;
+            for (int threads = 1; threads <= max_threads; threads++) {
+                StepResult step = RunStep(vm.GetJavaVM(), workloads[w], threads, seconds);
+                if (threads == 1) {
+                    single = step.ops_per_sec;
+                }
+                printf("%-8s %8d %14.0f %10.3f %10.3f %10.3f %10.1f%% %10.1f\n",
+                       kWorkloadNames[workloads[w]], threads, step.ops_per_sec, step.p50_us, step.p99_us,
+                       step.p999_us, 100 * step.ops_per_sec / (threads * single), step.attach_us);
+            }
+        }
+
+        CacheStats stats = MemberCache::GetInstance().GetStats();
+        printf("\nmember cache: %llu hits, %llu misses, %llu evictions, %zu bytes\n",
+               (unsigned long long) stats.hits, (unsigned long long) stats.misses,
+               (unsigned long long) stats.evictions, stats.bytes);
+        VmStartupReport report = vm.GetStartupReport();
+        printf("vm: %s in %.1f ms, first call after %.1f ms\n", report.created ? "created" : "joined",
+               report.create_ms, report.first_call_ms);
+    } catch (const Exception &e) {
+        fprintf(stderr, "%s\n", e.msg.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,287 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "boxing.h"
+
+#include <mutex>
+#include <string>
+
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        struct BoxType {
+            BoxType(const char *class_name, const char *value_of_sig, const char *unbox_class_name,
+                    const char *unbox_name, const char *unbox_sig, jint cache_low, jint cache_high)
+                    : class_name(class_name), value_of_sig(value_of_sig), unbox_class_name(unbox_class_name),
+                      unbox_name(unbox_name), unbox_sig(unbox_sig), cache_low(cache_low), cache_high(cache_high),
+                      clz(NULL), unbox_clz(NULL), value_of(NULL), unbox(NULL), cache(NULL) { };
+
+            const char *class_name;
+            const char *value_of_sig;
+            const char *unbox_class_name;
+            const char *unbox_name;
+            const char *unbox_sig;
+            jint cache_low;
+            jint cache_high;
+
+            jclass clz;
+            jclass unbox_clz;
+            jmethodID value_of;
+            jmethodID unbox;
+            jobject *cache;
+            once_flag once;
+        };
+
+        BoxType boolean_type("java/lang/Boolean", "(Z)Ljava/lang/Boolean;",
+                             "java/lang/Boolean", "booleanValue", "()Z", 0, 1);
+        BoxType byte_type("java/lang/Byte", "(B)Ljava/lang/Byte;",
+                          "java/lang/Number", "byteValue", "()B", -128, 127);
+        BoxType character_type("java/lang/Character", "(C)Ljava/lang/Character;",
+                               "java/lang/Character", "charValue", "()C", 0, 127);
+        BoxType short_type("java/lang/Short", "(S)Ljava/lang/Short;",
+                           "java/lang/Number", "shortValue", "()S", -128, 127);
+        BoxType integer_type("java/lang/Integer", "(I)Ljava/lang/Integer;",
+                             "java/lang/Number", "intValue", "()I", -128, 127);
+        BoxType long_type("java/lang/Long", "(J)Ljava/lang/Long;",
+                          "java/lang/Number", "longValue", "()J", -128, 127);
+        BoxType float_type("java/lang/Float", "(F)Ljava/lang/Float;",
+                           "java/lang/Number", "floatValue", "()F", 0, -1);
+        BoxType double_type("java/lang/Double", "(D)Ljava/lang/Double;",
+                            "java/lang/Number", "doubleValue", "()D", 0, -1);
+
+        jclass FindGlobalClass(JNIEnv *env, const char *name) {
+            jclass clz = env->FindClass(name);
+            CheckNotFoundException(env, string("class \"") + name + "\"");
+            jclass global = (jclass) env->NewGlobalRef(clz);
+            RefMonitor::OnCreate(kGlobalRef, global, "Boxing");
+            env->DeleteLocalRef(clz);
+            return global;
+        }
+
+        jobject CallValueOf(JNIEnv *env, BoxType &type, jvalue value) {
+            jobject result = env->CallStaticObjectMethodA(type.clz, type.value_of, &value);
+            CheckCallMethodException(env, "valueOf", type.value_of_sig, true);
+            return result;
+        }
+
+        void Init(JNIEnv *env, BoxType &type, jvalue (*make_value)(jint)) {
+            type.clz = FindGlobalClass(env, type.class_name);
+            type.unbox_clz = FindGlobalClass(env, type.unbox_class_name);
+            type.value_of = GetMethodID(env, type.clz, "valueOf", type.value_of_sig, true);
+            type.unbox = GetMethodID(env, type.unbox_clz, type.unbox_name, type.unbox_sig);
+
+            jint count = type.cache_high - type.cache_low + 1;
+            if (count <= 0) {
+                type.cache = NULL;
+                return;
+            }
+            jobject *cache = new jobject[count];
+            for (jint i = 0; i < count; i++) {
+                jobject box = CallValueOf(env, type, make_value(type.cache_low + i));
+                cache[i] = env->NewGlobalRef(box);
+                RefMonitor::OnCreate(kGlobalRef, cache[i], "Boxing");
+                env->DeleteLocalRef(box);
+            }
+            type.cache = cache;
+        }
+
+        BoxType &Get(JNIEnv *env, BoxType &type, jvalue (*make_value)(jint)) {
+            call_once(type.once, Init, env, ref(type), make_value);
+            return type;
+        }
+
+        jobject Box(JNIEnv *env, BoxType &type, jvalue (*make_value)(jint), jvalue value, jint cache_key) {
+            Get(env, type, make_value);
+            if (type.cache && cache_key >= type.cache_low && cache_key <= type.cache_high) {
+                return env->NewLocalRef(type.cache[cache_key - type.cache_low]);
+            }
+            return CallValueOf(env, type, value);
+        }
+
+        void CheckUnboxable(JNIEnv *env, BoxType &type, jobject box) {
+            if (!box) {
+                throw InvokeException(string("Cannot unbox null with \"") + type.unbox_name + "\".");
+            }
+            if (!env->IsInstanceOf(box, type.unbox_clz)) {
+                throw InvokeException(string("Cannot unbox an object that is not a ") + type.unbox_class_name + ".");
+            }
+        }
+
+        jvalue MakeZ(jint i) {
+            jvalue v;
+            v.z = (jboolean) i;
+            return v;
+        }
+
+        jvalue MakeB(jint i) {
+            jvalue v;
+            v.b = (jbyte) i;
+            return v;
+        }
+
+        jvalue MakeC(jint i) {
+            jvalue v;
+            v.c = (jchar) i;
+            return v;
+        }
+
+        jvalue MakeS(jint i) {
+            jvalue v;
+            v.s = (jshort) i;
+            return v;
+        }
+
+        jvalue MakeI(jint i) {
+            jvalue v;
+            v.i = i;
+            return v;
+        }
+
+        jvalue MakeJ(jint i) {
+            jvalue v;
+            v.j = i;
+            return v;
+        }
+
+        jvalue MakeF(jint i) {
+            jvalue v;
+            v.f = (jfloat) i;
+            return v;
+        }
+
+        jvalue MakeD(jint i) {
+            jvalue v;
+            v.d = i;
+            return v;
+        }
+    }
+
+#pragma mark - Box
+
+    jobject Box_Z(JNIEnv *env, jboolean value) {
+        return Box(env, boolean_type, MakeZ, MakeZ(value ? 1 : 0), value ? 1 : 0);
+    }
+
+    jobject Box_B(JNIEnv *env, jbyte value) {
+        return Box(env, byte_type, MakeB, MakeB(value), value);
+    }
+
+    jobject Box_C(JNIEnv *env, jchar value) {
+        return Box(env, character_type, MakeC, MakeC(value), value);
+    }
+
+    jobject Box_S(JNIEnv *env, jshort value) {
+        return Box(env, short_type, MakeS, MakeS(value), value);
+    }
+
+    jobject Box_I(JNIEnv *env, jint value) {
+        return Box(env, integer_type, MakeI, MakeI(value), value);
+    }
+
+    jobject Box_J(JNIEnv *env, jlong value) {
+        jvalue v;
+        v.j = value;
+        jint cache_key = (value >= long_type.cache_low && value <= long_type.cache_high) ? (jint) value : long_type.cache_high + 1;
+        return Box(env, long_type, MakeJ, v, cache_key);
+    }
+
+    jobject Box_F(JNIEnv *env, jfloat value) {
+        jvalue v;
+        v.f = value;
+        return Box(env, float_type, MakeF, v, 0);
+    }
+
+    jobject Box_D(JNIEnv *env, jdouble value) {
+        jvalue v;
+        v.d = value;
+        return Box(env, double_type, MakeD, v, 0);
+    }
+
+#pragma mark - Unbox
+
+    jboolean Unbox_Z(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, boolean_type, MakeZ);
+        CheckUnboxable(env, type, box);
+        jboolean result = env->CallBooleanMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jbyte Unbox_B(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, byte_type, MakeB);
+        CheckUnboxable(env, type, box);
+        jbyte result = env->CallByteMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jchar Unbox_C(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, character_type, MakeC);
+        CheckUnboxable(env, type, box);
+        jchar result = env->CallCharMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jshort Unbox_S(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, short_type, MakeS);
+        CheckUnboxable(env, type, box);
+        jshort result = env->CallShortMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jint Unbox_I(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, integer_type, MakeI);
+        CheckUnboxable(env, type, box);
+        jint result = env->CallIntMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jlong Unbox_J(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, long_type, MakeJ);
+        CheckUnboxable(env, type, box);
+        jlong result = env->CallLongMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jfloat Unbox_F(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, float_type, MakeF);
+        CheckUnboxable(env, type, box);
+        jfloat result = env->CallFloatMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+
+    jdouble Unbox_D(JNIEnv *env, jobject box) {
+        BoxType &type = Get(env, double_type, MakeD);
+        CheckUnboxable(env, type, box);
+        jdouble result = env->CallDoubleMethod(box, type.unbox);
+        CheckCallMethodException(env, type.unbox_name, type.unbox_sig);
+        return result;
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_BOXING_H
+#define NATIFLECT_BOXING_H
+
+#include <jni.h>
+
+#include "exception.h"
+
+namespace natiflect {
+
+    // Boxing and unboxing of java.lang wrapper types. Wrapper classes and their methods are resolved once
+    // per process, and boxes for small values (the ranges valueOf caches on the Java side) are kept as
+    // global references, so boxing those never calls into Java. All Box_* functions return local references.
+
+    jobject Box_Z(JNIEnv *env, jboolean value);
+
+    jobject Box_B(JNIEnv *env, jbyte value);
+
+    jobject Box_C(JNIEnv *env, jchar value);
+
+    jobject Box_S(JNIEnv *env, jshort value);
+
+    jobject Box_I(JNIEnv *env, jint value);
+
+    jobject Box_J(JNIEnv *env, jlong value);
+
+    jobject Box_F(JNIEnv *env, jfloat value);
+
+    jobject Box_D(JNIEnv *env, jdouble value);
+
+    // Numeric unboxing accepts any java.lang.Number, like Number.intValue() and friends do.
+
+    jboolean Unbox_Z(JNIEnv *env, jobject box);
+
+    jbyte Unbox_B(JNIEnv *env, jobject box);
+
+    jchar Unbox_C(JNIEnv *env, jobject box);
+
+    jshort Unbox_S(JNIEnv *env, jobject box);
+
+    jint Unbox_I(JNIEnv *env, jobject box);
+
+    jlong Unbox_J(JNIEnv *env, jobject box);
+
+    jfloat Unbox_F(JNIEnv *env, jobject box);
+
+    jdouble Unbox_D(JNIEnv *env, jobject box);
+}
+
+#endif //NATIFLECT_BOXING_H
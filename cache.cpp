@@ -0,0 +1,358 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "cache.h"
+
+#include <string.h>
+#include <vector>
+
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const size_t kDefaultMemberCacheCapacity = 1 << 20;
+        const size_t kDefaultClassCacheCapacity = 256 << 10;
+        const size_t kDefaultTypeCacheCapacity = 256 << 10;
+
+        // Values of TypeCache entries, which must not be NULL.
+        void *const kAssignable = (void *) 2;
+        void *const kNotAssignable = (void *) 1;
+
+        // Rough per-entry overhead of the list node and the index node on top of the entry itself.
+        const size_t kEntryOverhead = 64;
+
+        once_flag identity_once;
+        jclass system_class = NULL;
+        jmethodID identity_hash_code = NULL;
+
+        // Resolved without natiflect::GetMethodID, which goes through MemberCache.
+        jint IdentityHash(JNIEnv *env, jobject obj) {
+            call_once(identity_once, [env]() {
+                jclass clz = env->FindClass("java/lang/System");
+                if (!clz) {
+                    env->ExceptionClear();
+                    return;
+                }
+                identity_hash_code = env->GetStaticMethodID(clz, "identityHashCode", "(Ljava/lang/Object;)I");
+                if (!identity_hash_code) {
+                    env->ExceptionClear();
+                } else {
+                    system_class = (jclass) env->NewGlobalRef(clz);
+                    RefMonitor::OnCreate(kGlobalRef, system_class, "WeakRefCache");
+                }
+                env->DeleteLocalRef(clz);
+            });
+            if (!system_class) {
+                return 0;
+            }
+            jint hash = env->CallStaticIntMethod(system_class, identity_hash_code, obj);
+            if (env->ExceptionCheck()) {
+                env->ExceptionClear();
+                return 0;
+            }
+            return hash;
+        }
+    }
+
+#pragma mark - WeakRefCache
+
+    WeakRefCache::WeakRefCache(size_t capacity, bool keyed_by_class)
+            : keyed_by_class_(keyed_by_class), capacity_(capacity) {
+        for (size_t i = 0; i < kShardCount; i++) {
+            memset(&shards_[i].stats_, 0, sizeof(shards_[i].stats_));
+        }
+    }
+
+    CacheStats WeakRefCache::GetStats() {
+        CacheStats result;
+        memset(&result, 0, sizeof(result));
+        for (size_t i = 0; i < kShardCount; i++) {
+            lock_guard<mutex> lock(shards_[i].mutex_);
+            const CacheStats &stats = shards_[i].stats_;
+            result.hits += stats.hits;
+            result.misses += stats.misses;
+            result.evictions += stats.evictions;
+            result.stale += stats.stale;
+            result.entries += stats.entries;
+            result.bytes += stats.bytes;
+        }
+        result.capacity = GetCapacity();
+        return result;
+    }
+
+    void WeakRefCache::SetCapacity(JNIEnv *env, size_t capacity) {
+        capacity_.store(capacity, memory_order_relaxed);
+        for (size_t i = 0; i < kShardCount; i++) {
+            lock_guard<mutex> lock(shards_[i].mutex_);
+            Evict(env, shards_[i]);
+        }
+    }
+
+    void WeakRefCache::Purge(JNIEnv *env) {
+        for (size_t i = 0; i < kShardCount; i++) {
+            Shard &shard = shards_[i];
+            lock_guard<mutex> lock(shard.mutex_);
+            EntryIndex::iterator it = shard.index_.begin();
+            while (it != shard.index_.end()) {
+                EntryIndex::iterator current = it++;
+                if (env->IsSameObject(current->second->clz, NULL)) {
+                    Erase(env, shard, current);
+                    shard.stats_.stale++;
+                }
+            }
+        }
+    }
+
+    void WeakRefCache::Clear(JNIEnv *env) {
+        for (size_t i = 0; i < kShardCount; i++) {
+            Shard &shard = shards_[i];
+            lock_guard<mutex> lock(shard.mutex_);
+            for (EntryList::iterator it = shard.entries_.begin(); it != shard.entries_.end(); ++it) {
+                RefMonitor::OnDelete(kWeakGlobalRef, it->clz, "WeakRefCache");
+                env->DeleteWeakGlobalRef(it->clz);
+            }
+            shard.entries_.clear();
+            shard.index_.clear();
+            shard.stats_.entries = 0;
+            shard.stats_.bytes = 0;
+        }
+    }
+
+    void *WeakRefCache::Find(JNIEnv *env, uint64_t hash, const char *name, const char *sig, char kind,
+                             jclass receiver) {
+        if (keyed_by_class_) {
+            hash = GetKey(env, hash, receiver);
+        }
+        Shard &shard = GetShard(hash);
+        lock_guard<mutex> lock(shard.mutex_);
+        pair<EntryIndex::iterator, EntryIndex::iterator> range = shard.index_.equal_range(hash);
+        EntryIndex::iterator it = range.first;
+        while (it != range.second) {
+            EntryIndex::iterator current = it++;
+            Entry &entry = *current->second;
+            if (!Matches(entry, name, sig, kind)) {
+                continue;
+            }
+
+            void *result;
+            if (receiver) {
+                if (!env->IsSameObject(entry.clz, receiver)) {
+                    if (env->IsSameObject(entry.clz, NULL)) {
+                        Erase(env, shard, current);
+                        shard.stats_.stale++;
+                    }
+                    continue;
+                }
+                result = entry.value;
+            } else {
+                result = env->NewLocalRef(entry.clz);
+                if (!result) {
+                    Erase(env, shard, current);
+                    shard.stats_.stale++;
+                    continue;
+                }
+            }
+
+            shard.entries_.splice(shard.entries_.begin(), shard.entries_, current->second);
+            shard.stats_.hits++;
+            return result;
+        }
+        shard.stats_.misses++;
+        return NULL;
+    }
+
+    uint64_t WeakRefCache::GetKey(JNIEnv *env, uint64_t hash, jclass clz) {
+        // Multiplied so that the identity hash reaches the high bits, which pick the shard.
+        return hash ^ ((uint64_t) (uint32_t) IdentityHash(env, clz) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    bool WeakRefCache::Matches(const Entry &entry, const char *name, const char *sig, char kind) {
+        if (entry.kind != kind) {
+            return false;
+        }
+        if (entry.name_address == (uintptr_t) name && entry.sig_address == (uintptr_t) sig) {
+            return true;
+        }
+        return entry.name == name && entry.sig == sig;
+    }
+
+    void WeakRefCache::Put(JNIEnv *env, uint64_t hash, const char *name, const char *sig, char kind, jclass clz,
+                           void *value) {
+        if (GetCapacity() == 0) {
+            return;
+        }
+        if (keyed_by_class_) {
+            hash = GetKey(env, hash, clz);
+        }
+        Shard &shard = GetShard(hash);
+        lock_guard<mutex> lock(shard.mutex_);
+        pair<EntryIndex::iterator, EntryIndex::iterator> range = shard.index_.equal_range(hash);
+        for (EntryIndex::iterator it = range.first; it != range.second; ++it) {
+            const Entry &existing = *it->second;
+            if (Matches(existing, name, sig, kind)
+                && env->IsSameObject(existing.clz, clz)) {
+                // Another thread got here first.
+                return;
+            }
+        }
+
+        Entry entry;
+        entry.hash = hash;
+        entry.name = name;
+        entry.sig = sig;
+        entry.name_address = (uintptr_t) name;
+        entry.sig_address = (uintptr_t) sig;
+        entry.kind = kind;
+        entry.clz = env->NewWeakGlobalRef(clz);
+        entry.value = value;
+        entry.bytes = sizeof(Entry) + entry.name.size() + entry.sig.size() + kEntryOverhead;
+        if (!entry.clz) {
+            env->ExceptionClear();
+            return;
+        }
+        RefMonitor::OnCreate(kWeakGlobalRef, entry.clz, "WeakRefCache");
+
+        shard.entries_.push_front(entry);
+        shard.index_.insert(make_pair(hash, shard.entries_.begin()));
+        shard.stats_.entries++;
+        shard.stats_.bytes += entry.bytes;
+        Evict(env, shard);
+    }
+
+    void WeakRefCache::Erase(JNIEnv *env, Shard &shard, EntryIndex::iterator index_it) {
+        EntryList::iterator entry_it = index_it->second;
+        RefMonitor::OnDelete(kWeakGlobalRef, entry_it->clz, "WeakRefCache");
+        env->DeleteWeakGlobalRef(entry_it->clz);
+        shard.stats_.entries--;
+        shard.stats_.bytes -= entry_it->bytes;
+        shard.index_.erase(index_it);
+        shard.entries_.erase(entry_it);
+    }
+
+    void WeakRefCache::Evict(JNIEnv *env, Shard &shard) {
+        size_t capacity = GetCapacity() / kShardCount;
+        while (shard.stats_.bytes > capacity && !shard.entries_.empty()) {
+            EntryList::iterator last = --shard.entries_.end();
+            pair<EntryIndex::iterator, EntryIndex::iterator> range = shard.index_.equal_range(last->hash);
+            for (EntryIndex::iterator it = range.first; it != range.second; ++it) {
+                if (it->second == last) {
+                    Erase(env, shard, it);
+                    break;
+                }
+            }
+            shard.stats_.evictions++;
+        }
+    }
+
+#pragma mark - MemberCache
+
+    MemberCache::MemberCache() : WeakRefCache(kDefaultMemberCacheCapacity, true) {
+    }
+
+    MemberCache &MemberCache::GetInstance() {
+        static MemberCache instance;
+        return instance;
+    }
+
+    jmethodID MemberCache::FindMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                                        uint64_t hash) {
+        return (jmethodID) Find(env, hash, name, sig, is_static ? 'S' : 'M', clz);
+    }
+
+    void MemberCache::PutMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                                  uint64_t hash, jmethodID method_id) {
+        Put(env, hash, name, sig, is_static ? 'S' : 'M', clz, method_id);
+    }
+
+    jfieldID MemberCache::FindFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                                      uint64_t hash) {
+        return (jfieldID) Find(env, hash, name, sig, is_static ? 'G' : 'F', clz);
+    }
+
+    void MemberCache::PutFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                                 uint64_t hash, jfieldID field_id) {
+        Put(env, hash, name, sig, is_static ? 'G' : 'F', clz, field_id);
+    }
+
+#pragma mark - ClassCache
+
+    ClassCache::ClassCache() : WeakRefCache(kDefaultClassCacheCapacity, false) {
+        get_class_loader_ = NULL;
+    }
+
+    ClassCache &ClassCache::GetInstance() {
+        static ClassCache instance;
+        return instance;
+    }
+
+    jclass ClassCache::Find(JNIEnv *env, const char *name) {
+        return (jclass) WeakRefCache::Find(env, HashMember(name, ""), name, "", 'C', NULL);
+    }
+
+    bool ClassCache::Put(JNIEnv *env, const char *name, jclass clz) {
+        if (GetCapacity() == 0 || !IsCacheable(env, clz)) {
+            return false;
+        }
+        WeakRefCache::Put(env, HashMember(name, ""), name, "", 'C', clz, NULL);
+        return true;
+    }
+
+    bool ClassCache::IsCacheable(JNIEnv *env, jclass clz) {
+        call_once(init_once_, [this, env]() {
+            LocalFrame frame(env, 2);
+            jclass clz_class = env->FindClass("java/lang/Class");
+            CheckNotFoundException(env, "class \"java/lang/Class\"");
+            get_class_loader_ = natiflect::GetMethodID(env, clz_class, "getClassLoader",
+                                                       "()Ljava/lang/ClassLoader;");
+        });
+
+        jobject loader = env->CallObjectMethod(clz, get_class_loader_);
+        CheckCallMethodException(env, "getClassLoader", "()Ljava/lang/ClassLoader;");
+        bool result = !loader;
+        env->DeleteLocalRef(loader);
+        return result;
+    }
+
+#pragma mark - TypeCache
+
+    TypeCache::TypeCache() : WeakRefCache(kDefaultTypeCacheCapacity, true) {
+    }
+
+    TypeCache &TypeCache::GetInstance() {
+        static TypeCache instance;
+        return instance;
+    }
+
+    int TypeCache::Find(JNIEnv *env, jclass clz, const char *target, uint64_t hash) {
+        void *value = WeakRefCache::Find(env, hash, target, "", 'T', clz);
+        if (!value) {
+            return -1;
+        }
+        return value == kAssignable ? 1 : 0;
+    }
+
+    void TypeCache::Put(JNIEnv *env, jclass clz, const char *target, uint64_t hash, bool assignable) {
+        WeakRefCache::Put(env, hash, target, "", 'T', clz, assignable ? kAssignable : kNotAssignable);
+    }
+}
@@ -0,0 +1,188 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_CACHE_H
+#define NATIFLECT_CACHE_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+
+namespace natiflect {
+
+    struct CacheStats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        // Entries dropped because their class has been unloaded.
+        uint64_t stale;
+        size_t entries;
+        size_t bytes;
+        size_t capacity;
+    };
+
+    // A process-wide LRU cache whose entries belong to a class held through a weak global reference,
+    // so caching never keeps a class (or its ClassLoader) alive, and entries of unloaded classes are
+    // detected and dropped. The memory used by the entries is bounded by the capacity in bytes;
+    // a capacity of 0 disables the cache. Entries are spread by key over shards that each have their
+    // own lock, LRU order and an even share of the capacity, so threads looking up different members
+    // rarely wait for each other. In caches keyed by class, the key mixes the identity hash code of the
+    // class into the hash of the member, so that the same member of many classes, such as toString,
+    // spreads over shards and buckets instead of forming one long chain.
+    class WeakRefCache {
+    public:
+        WeakRefCache(size_t capacity, bool keyed_by_class);
+
+        CacheStats GetStats();
+
+        void SetCapacity(JNIEnv *env, size_t capacity);
+
+        // Drops all entries whose class has been unloaded.
+        void Purge(JNIEnv *env);
+
+        void Clear(JNIEnv *env);
+
+    protected:
+        struct Entry {
+            // The key, see GetKey().
+            uint64_t hash;
+            string name;
+            string sig;
+            // Addresses of the strings the entry was created from. Keys are usually string literals,
+            // so a lookup from the same call site matches without comparing the strings; the hash
+            // has already matched, so equal addresses can be trusted. Never dereferenced.
+            uintptr_t name_address;
+            uintptr_t sig_address;
+            char kind;
+            jweak clz;
+            void *value;
+            size_t bytes;
+        };
+
+        // With a receiver, which caches keyed by class require, finds the entry whose class is the
+        // receiver and returns its value. Without one, returns a new local reference to the class of
+        // the entry, or NULL.
+        void *Find(JNIEnv *env, uint64_t hash, const char *name, const char *sig, char kind, jclass receiver);
+
+        size_t GetCapacity() const { return capacity_.load(memory_order_relaxed); };
+
+        void Put(JNIEnv *env, uint64_t hash, const char *name, const char *sig, char kind, jclass clz, void *value);
+
+    private:
+        typedef list<Entry> EntryList;
+        typedef unordered_multimap<uint64_t, EntryList::iterator> EntryIndex;
+
+        static const size_t kShardCount = 16;
+
+        struct Shard {
+            mutex mutex_;
+            EntryList entries_;
+            EntryIndex index_;
+            // The capacity is kept by the cache.
+            CacheStats stats_;
+        };
+
+        static bool Matches(const Entry &entry, const char *name, const char *sig, char kind);
+
+        // Costs one identityHashCode call in caches keyed by class.
+        uint64_t GetKey(JNIEnv *env, uint64_t hash, jclass clz);
+
+        Shard &GetShard(uint64_t hash) {
+            // The low bits also pick the bucket of the index, so the shard is taken from the high ones.
+            return shards_[(size_t) (hash >> 60) % kShardCount];
+        };
+
+        void Erase(JNIEnv *env, Shard &shard, EntryIndex::iterator index_it);
+
+        void Evict(JNIEnv *env, Shard &shard);
+
+        bool keyed_by_class_;
+        atomic<size_t> capacity_;
+        Shard shards_[kShardCount];
+    };
+
+    // Caches method and field IDs by (class, name, sig). GetMethodID/GetFieldID in utils.h go through it.
+    class MemberCache : public WeakRefCache {
+    public:
+        static MemberCache &GetInstance();
+
+        jmethodID FindMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                               uint64_t hash);
+
+        void PutMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static, uint64_t hash,
+                         jmethodID method_id);
+
+        jfieldID FindFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                             uint64_t hash);
+
+        void PutFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static, uint64_t hash,
+                        jfieldID field_id);
+
+    private:
+        MemberCache();
+    };
+
+    // Caches classes found by name. Only classes defined by the bootstrap class loader are cached: FindClass
+    // resolves through the loader of the calling native method, which may resolve the same name to a class
+    // of its own, but every loader delegates java.* and other bootstrap classes to the bootstrap loader.
+    class ClassCache : public WeakRefCache {
+    public:
+        static ClassCache &GetInstance();
+
+        // Returns a new local reference, or NULL on a miss.
+        jclass Find(JNIEnv *env, const char *name);
+
+        // Returns whether clz was cached.
+        bool Put(JNIEnv *env, const char *name, jclass clz);
+
+    private:
+        ClassCache();
+
+        bool IsCacheable(JNIEnv *env, jclass clz);
+
+        once_flag init_once_;
+        jmethodID get_class_loader_;
+    };
+
+    // Caches whether a class is assignable to a class given by name, for Object<T>::Is and As. Only
+    // answers for targets defined by the bootstrap loader may be put, for the same reason ClassCache only
+    // holds those: any other name may stand for different classes under different loaders.
+    class TypeCache : public WeakRefCache {
+    public:
+        static TypeCache &GetInstance();
+
+        // Returns 1 if clz is assignable to target, 0 if not, or -1 on a miss.
+        int Find(JNIEnv *env, jclass clz, const char *target, uint64_t hash);
+
+        void Put(JNIEnv *env, jclass clz, const char *target, uint64_t hash, bool assignable);
+
+    private:
+        TypeCache();
+    };
+}
+
+#endif //NATIFLECT_CACHE_H
@@ -0,0 +1,108 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "call_site.h"
+
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    CallSite::CallSite(MemberKey key, bool is_static) : key_(key), is_static_(is_static) {
+        for (int i = 0; i < kMaxEntries; i++) {
+            entries_[i].store(NULL, memory_order_relaxed);
+        }
+        retired_.store(NULL, memory_order_relaxed);
+    }
+
+    CallSite::~CallSite() {
+        // The weak references are left to the VM; call sites live until the process exits.
+        for (int i = 0; i < kMaxEntries; i++) {
+            delete entries_[i].load(memory_order_relaxed);
+        }
+        Entry *entry = retired_.load(memory_order_relaxed);
+        while (entry) {
+            Entry *next = entry->next;
+            delete entry;
+            entry = next;
+        }
+    }
+
+    jmethodID CallSite::GetMethodID(JNIEnv *env, jclass clz) {
+        int free_slot = kMaxEntries;
+        int stale_slot = kMaxEntries;
+        Entry *stale = NULL;
+        for (int i = 0; i < kMaxEntries; i++) {
+            Entry *entry = entries_[i].load(memory_order_acquire);
+            if (!entry) {
+                free_slot = i;
+                break;
+            }
+            if (env->IsSameObject(entry->clz, clz)) {
+                return entry->method_id;
+            }
+            if (!stale && env->IsSameObject(entry->clz, NULL)) {
+                stale_slot = i;
+                stale = entry;
+            }
+        }
+
+        jmethodID method_id = natiflect::GetMethodID(env, clz, key_, is_static_);
+        if (free_slot == kMaxEntries && !stale) {
+            return method_id;
+        }
+
+        Entry *entry = new Entry;
+        entry->clz = env->NewWeakGlobalRef(clz);
+        entry->method_id = method_id;
+        entry->next = NULL;
+        if (!entry->clz) {
+            env->ExceptionClear();
+            delete entry;
+            return method_id;
+        }
+        RefMonitor::OnCreate(kWeakGlobalRef, entry->clz, "CallSite");
+        for (int i = free_slot; i < kMaxEntries; i++) {
+            Entry *expected = NULL;
+            if (entries_[i].compare_exchange_strong(expected, entry, memory_order_release, memory_order_relaxed)) {
+                return method_id;
+            }
+        }
+        if (stale && entries_[stale_slot].compare_exchange_strong(stale, entry, memory_order_release,
+                                                                  memory_order_relaxed)) {
+            Retire(stale);
+            return method_id;
+        }
+        // Other threads filled the remaining slots.
+        RefMonitor::OnDelete(kWeakGlobalRef, entry->clz, "CallSite");
+        env->DeleteWeakGlobalRef(entry->clz);
+        delete entry;
+        return method_id;
+    }
+
+    void CallSite::Retire(Entry *entry) {
+        // Neither the entry nor its weak reference can be freed while other threads may be reading them.
+        Entry *head = retired_.load(memory_order_relaxed);
+        do {
+            entry->next = head;
+        } while (!retired_.compare_exchange_weak(head, entry, memory_order_release, memory_order_relaxed));
+    }
+}
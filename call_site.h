@@ -0,0 +1,83 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_CALL_SITE_H
+#define NATIFLECT_CALL_SITE_H
+
+#include <jni.h>
+#include <atomic>
+
+#include "member_key.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // An inline cache for one call site. It remembers the method IDs resolved for the first few receiver
+    // classes seen at the site, guarded by class identity, and goes to MemberCache for any other class.
+    // The slot of a class that has been unloaded is given to the next new class.
+    // Create call sites with NF_CALL_SITE, which keeps one per place it appears in the code.
+    class CallSite {
+    public:
+        static const int kMaxEntries = 4;
+
+        explicit CallSite(MemberKey key, bool is_static = false);
+
+        ~CallSite();
+
+        // Throws NotFoundException if the method does not exist.
+        jmethodID GetMethodID(JNIEnv *env, jclass clz);
+
+        const char *GetName() const { return key_.name; };
+
+        const char *GetSignature() const { return key_.sig; };
+
+    private:
+        CallSite(const CallSite &);
+
+        CallSite &operator=(const CallSite &);
+
+        struct Entry {
+            jweak clz;
+            jmethodID method_id;
+            // Links retired entries.
+            Entry *next;
+        };
+
+        void Retire(Entry *entry);
+
+        MemberKey key_;
+        bool is_static_;
+        // Filled in order, and only replaced once the class of the entry has been unloaded.
+        atomic<Entry *> entries_[kMaxEntries];
+        // Replaced entries, which other threads may still be reading, kept until the site is destroyed.
+        // There is one per class unloaded while it had a slot.
+        atomic<Entry *> retired_;
+    };
+}
+
+#define NF_CALL_SITE(name, sig) \
+    ([]() -> ::natiflect::CallSite * { \
+        static ::natiflect::CallSite site(NF_MEMBER(name, sig)); \
+        return &site; \
+    }())
+
+#endif //NATIFLECT_CALL_SITE_H
@@ -0,0 +1,125 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "checked.h"
+
+#ifdef NATIFLECT_CHECKED
+
+#include <string>
+
+#include "exception.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    static void CheckEnv(JNIEnv *env, const char *name) {
+        JavaVM *vm;
+        if (env->GetJavaVM(&vm) != JNI_OK || GetAttachedEnv(vm) != env) {
+            throw ValidationException(string("\"") + name + "\" is accessed with a JNIEnv of another thread.");
+        }
+    }
+
+    static void CheckReference(JNIEnv *env, jobject ref, const char *name, const char *what) {
+        if (!ref) {
+            throw ValidationException(string("\"") + name + "\" is accessed through a null " + what + ".");
+        }
+        if (env->GetObjectRefType(ref) == JNIInvalidRefType) {
+            throw ValidationException(string("\"") + name + "\" is accessed through an invalid " + what
+                                      + " reference, such as a local reference used out of its frame.");
+        }
+    }
+
+    static string TypeName(char type) {
+        switch (type) {
+            case 'V':
+                return "void";
+            case 'L':
+                return "an object";
+            default:
+                return string("\"") + type + "\"";
+        }
+    }
+
+    void CheckCall(JNIEnv *env, jobject receiver, const char *name, const char *sig, char return_type) {
+        CheckEnv(env, name);
+        CheckReference(env, receiver, name, "receiver");
+
+        string param_types;
+        char actual_return_type;
+        if (!ParseMethodSignature(sig, &param_types, &actual_return_type)) {
+            throw ValidationException(string("Method \"") + name + "\" has a malformed signature \"" + sig + "\".");
+        }
+        if (actual_return_type != return_type) {
+            throw ValidationException(string("Method \"") + name + "\" with signature \"" + sig + "\" returns "
+                                      + TypeName(actual_return_type) + " but is called for "
+                                      + TypeName(return_type) + ".");
+        }
+    }
+
+    void CheckArguments(JNIEnv *env, const char *name, const char *sig, va_list args) {
+        string param_types;
+        char return_type;
+        if (!ParseMethodSignature(sig, &param_types, &return_type)) {
+            throw ValidationException(string("Method \"") + name + "\" has a malformed signature \"" + sig + "\".");
+        }
+
+        va_list copy;
+        va_copy(copy, args);
+        for (size_t i = 0; i < param_types.size(); i++) {
+            switch (param_types[i]) {
+                case 'J':
+                    va_arg(copy, jlong);
+                    break;
+                case 'F':
+                case 'D':
+                    va_arg(copy, jdouble);
+                    break;
+                case 'L': {
+                    jobject arg = va_arg(copy, jobject);
+                    if (arg && env->GetObjectRefType(arg) == JNIInvalidRefType) {
+                        va_end(copy);
+                        throw ValidationException(string("Argument ") + to_string(i) + " of method \"" + name
+                                                  + "\" is an invalid reference.");
+                    }
+                    break;
+                }
+                default:
+                    // Narrower types are promoted to int.
+                    va_arg(copy, jint);
+                    break;
+            }
+        }
+        va_end(copy);
+    }
+
+    void CheckField(JNIEnv *env, jobject receiver, const char *name, const char *sig, char type) {
+        CheckEnv(env, name);
+        CheckReference(env, receiver, name, "receiver");
+
+        bool matches = type == 'L' ? (sig[0] == 'L' || sig[0] == '[') : (sig[0] == type && sig[1] == '\0');
+        if (!matches) {
+            throw ValidationException(string("Field \"") + name + "\" with signature \"" + sig + "\" is accessed as "
+                                      + TypeName(type) + ".");
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_CHECKED_H
+#define NATIFLECT_CHECKED_H
+
+#include <jni.h>
+#include <stdarg.h>
+
+// Checked mode, enabled by defining NATIFLECT_CHECKED (the NATIFLECT_CHECKED CMake option), validates
+// every call and field access made through Object and Class and throws ValidationException on misuse
+// that JNI would otherwise let through silently. Without it the checks below expand to nothing.
+
+#ifdef NATIFLECT_CHECKED
+
+namespace natiflect {
+
+    // Checks that env belongs to the current thread, that the receiver is a valid reference, that the
+    // signature is well-formed and that it returns return_type (as in the Call_X suffix, 'L' for
+    // objects and arrays).
+    void CheckCall(JNIEnv *env, jobject receiver, const char *name, const char *sig, char return_type);
+
+    // Checks that every object argument passed for sig is NULL or a valid reference. C varargs carry
+    // no count, so the arguments are read as the signature declares them.
+    void CheckArguments(JNIEnv *env, const char *name, const char *sig, va_list args);
+
+    // Same as CheckCall for a field whose type must be type.
+    void CheckField(JNIEnv *env, jobject receiver, const char *name, const char *sig, char type);
+}
+
+#define NF_CHECK_CALL(env, receiver, name, sig, return_type) \
+    ::natiflect::CheckCall((env), (receiver), (name), (sig), (return_type))
+#define NF_CHECK_ARGUMENTS(env, name, sig, args) ::natiflect::CheckArguments((env), (name), (sig), (args))
+#define NF_CHECK_FIELD(env, receiver, name, sig, type) \
+    ::natiflect::CheckField((env), (receiver), (name), (sig), (type))
+
+#else
+
+#define NF_CHECK_CALL(env, receiver, name, sig, return_type) ((void) 0)
+#define NF_CHECK_ARGUMENTS(env, name, sig, args) ((void) 0)
+#define NF_CHECK_FIELD(env, receiver, name, sig, type) ((void) 0)
+
+#endif
+
+#endif //NATIFLECT_CHECKED_H
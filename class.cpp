@@ -25,6 +25,12 @@
 #include "class.h"
 
 #include "utils.h"
+#include "checked.h"
+#include "boxing.h"
+#include "cache.h"
+#include "ref_monitor.h"
+#include "vm.h"
+#include "warmup.h"
 
 namespace natiflect {
 
@@ -32,124 +38,276 @@ namespace natiflect {
 
     Class::Class(JNIEnv *env, const char *name) {
         env_ = env;
-        val_ = env_->FindClass(name);
-        CheckNotFoundException(env_, string("class \"") + name + "\"");
+        val_ = ClassCache::GetInstance().Find(env_, name);
+        if (!val_) {
+            val_ = env_->FindClass(name);
+            CheckNotFoundException(env_, string("class \"") + name + "\"");
+            ClassCache::GetInstance().Put(env_, name, val_);
+            Warmup::OnClassFound(env_, name);
+        }
+        RefMonitor::OnCreate(kLocalRef, val_, "Class::FindClass");
     }
 
 #pragma mark - Static Method
 
     void Class::CallStatic_V(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'V');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         env_->CallStaticVoidMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
     }
 
     jboolean Class::CallStatic_Z(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'Z');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jboolean result = env_->CallStaticBooleanMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jbyte Class::CallStatic_B(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'B');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jbyte result = env_->CallStaticByteMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jchar Class::CallStatic_C(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'C');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jchar result = env_->CallStaticCharMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jshort Class::CallStatic_S(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'S');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jshort result = env_->CallStaticShortMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jint Class::CallStatic_I(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'I');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jint result = env_->CallStaticIntMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jlong Class::CallStatic_J(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'J');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jlong result = env_->CallStaticLongMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jfloat Class::CallStatic_F(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'F');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jfloat result = env_->CallStaticFloatMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jdouble Class::CallStatic_D(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'D');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jdouble result = env_->CallStaticDoubleMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
         return result;
     }
 
     jobject Class::CallStatic_L(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
         jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
 
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Class::CallStatic_L");
         return result;
     }
 
+#pragma mark - Static Method Returning Boxed Value
+
+    jboolean Class::CallStaticUnboxed_Z(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_Z);
+    }
+
+    jbyte Class::CallStaticUnboxed_B(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_B);
+    }
+
+    jchar Class::CallStaticUnboxed_C(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_C);
+    }
+
+    jshort Class::CallStaticUnboxed_S(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_S);
+    }
+
+    jint Class::CallStaticUnboxed_I(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_I);
+    }
+
+    jlong Class::CallStaticUnboxed_J(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_J);
+    }
+
+    jfloat Class::CallStaticUnboxed_F(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_F);
+    }
+
+    jdouble Class::CallStaticUnboxed_D(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, name, sig, true);
+
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig, true);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_D);
+    }
+
 #pragma mark - Static Field
 
     jboolean Class::GetStatic_Z(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "Z", 'Z');
         jfieldID field_id = GetFieldID(env_, val_, name, "Z", true);
         jboolean result = env_->GetStaticBooleanField(val_, field_id);
         CheckAccessFieldException(env_, name, "Z", true);
@@ -157,12 +315,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_Z(const char *name, jboolean value) {
+        NF_CHECK_FIELD(env_, val_, name, "Z", 'Z');
         jfieldID field_id = GetFieldID(env_, val_, name, "Z", true);
         env_->SetStaticBooleanField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "Z", true);
     }
 
     jbyte Class::GetStatic_B(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "B", 'B');
         jfieldID field_id = GetFieldID(env_, val_, name, "B", true);
         jbyte result = env_->GetStaticByteField(val_, field_id);
         CheckAccessFieldException(env_, name, "B", true);
@@ -170,12 +330,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_B(const char *name, jbyte value) {
+        NF_CHECK_FIELD(env_, val_, name, "B", 'B');
         jfieldID field_id = GetFieldID(env_, val_, name, "B", true);
         env_->SetStaticByteField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "B", true);
     }
 
     jchar Class::GetStatic_C(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "C", 'C');
         jfieldID field_id = GetFieldID(env_, val_, name, "C", true);
         jchar result = env_->GetStaticCharField(val_, field_id);
         CheckAccessFieldException(env_, name, "C", true);
@@ -183,12 +345,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_C(const char *name, jchar value) {
+        NF_CHECK_FIELD(env_, val_, name, "C", 'C');
         jfieldID field_id = GetFieldID(env_, val_, name, "C", true);
         env_->SetStaticCharField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "C", true);
     }
 
     jshort Class::GetStatic_S(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "S", 'S');
         jfieldID field_id = GetFieldID(env_, val_, name, "S", true);
         jshort result = env_->GetStaticShortField(val_, field_id);
         CheckAccessFieldException(env_, name, "S", true);
@@ -196,12 +360,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_S(const char *name, jshort value) {
+        NF_CHECK_FIELD(env_, val_, name, "S", 'S');
         jfieldID field_id = GetFieldID(env_, val_, name, "S", true);
         env_->SetStaticShortField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "S", true);
     }
 
     jint Class::GetStatic_I(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "I", 'I');
         jfieldID field_id = GetFieldID(env_, val_, name, "I", true);
         jint result = env_->GetStaticIntField(val_, field_id);
         CheckAccessFieldException(env_, name, "I", true);
@@ -209,12 +375,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_I(const char *name, jint value) {
+        NF_CHECK_FIELD(env_, val_, name, "I", 'I');
         jfieldID field_id = GetFieldID(env_, val_, name, "I", true);
         env_->SetStaticIntField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "I", true);
     }
 
     jlong Class::GetStatic_J(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "J", 'J');
         jfieldID field_id = GetFieldID(env_, val_, name, "J", true);
         jlong result = env_->GetStaticLongField(val_, field_id);
         CheckAccessFieldException(env_, name, "J", true);
@@ -222,12 +390,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_J(const char *name, jlong value) {
+        NF_CHECK_FIELD(env_, val_, name, "J", 'J');
         jfieldID field_id = GetFieldID(env_, val_, name, "J", true);
         env_->SetStaticLongField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "J", true);
     }
 
     jfloat Class::GetStatic_F(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "F", 'F');
         jfieldID field_id = GetFieldID(env_, val_, name, "F", true);
         jfloat result = env_->GetStaticFloatField(val_, field_id);
         CheckAccessFieldException(env_, name, "F", true);
@@ -235,12 +405,14 @@ namespace natiflect {
     }
 
     void Class::SetStatic_F(const char *name, jfloat value) {
+        NF_CHECK_FIELD(env_, val_, name, "F", 'F');
         jfieldID field_id = GetFieldID(env_, val_, name, "F", true);
         env_->SetStaticFloatField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "F", true);
     }
 
     jdouble Class::GetStatic_D(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "D", 'D');
         jfieldID field_id = GetFieldID(env_, val_, name, "D", true);
         jdouble result = env_->GetStaticDoubleField(val_, field_id);
         CheckAccessFieldException(env_, name, "D", true);
@@ -248,45 +420,359 @@ namespace natiflect {
     }
 
     void Class::SetStatic_D(const char *name, jdouble value) {
+        NF_CHECK_FIELD(env_, val_, name, "D", 'D');
         jfieldID field_id = GetFieldID(env_, val_, name, "D", true);
         env_->SetStaticDoubleField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "D", true);
     }
 
     jobject Class::GetStatic_L(const char *name, const char *sig) {
+        NF_CHECK_FIELD(env_, val_, name, sig, 'L');
         jfieldID field_id = GetFieldID(env_, val_, name, sig, true);
         jobject result = env_->GetStaticObjectField(val_, field_id);
         CheckAccessFieldException(env_, name, sig, true);
+        RefMonitor::OnCreate(kLocalRef, result, "Class::GetStatic_L");
         return result;
     }
 
     void Class::SetStatic_L(const char *name, const char *sig, jobject value) {
+        NF_CHECK_FIELD(env_, val_, name, sig, 'L');
         jfieldID field_id = GetFieldID(env_, val_, name, sig, true);
         env_->SetStaticObjectField(val_, field_id, value);
         CheckAccessFieldException(env_, name, sig, true);
     }
 
+#pragma mark - Static Method With Member Key
+
+    void Class::CallStatic_V(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'V');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        env_->CallStaticVoidMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+    }
+
+    jboolean Class::CallStatic_Z(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'Z');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jboolean result = env_->CallStaticBooleanMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jbyte Class::CallStatic_B(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'B');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jbyte result = env_->CallStaticByteMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jchar Class::CallStatic_C(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'C');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jchar result = env_->CallStaticCharMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jshort Class::CallStatic_S(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'S');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jshort result = env_->CallStaticShortMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jint Class::CallStatic_I(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'I');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jint result = env_->CallStaticIntMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jlong Class::CallStatic_J(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'J');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jlong result = env_->CallStaticLongMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jfloat Class::CallStatic_F(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'F');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jfloat result = env_->CallStaticFloatMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jdouble Class::CallStatic_D(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'D');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jdouble result = env_->CallStaticDoubleMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        return result;
+    }
+
+    jobject Class::CallStatic_L(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'L');
+        jmethodID method_id = GetMethodID(env_, val_, key, true);
+
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jobject result = env_->CallStaticObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig, true);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Class::CallStatic_L");
+        return result;
+    }
+
+#pragma mark - Static Field With Member Key
+
+    jboolean Class::GetStatic_Z(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'Z');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jboolean result = env_->GetStaticBooleanField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_Z(MemberKey key, jboolean value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'Z');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticBooleanField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jbyte Class::GetStatic_B(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'B');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jbyte result = env_->GetStaticByteField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_B(MemberKey key, jbyte value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'B');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticByteField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jchar Class::GetStatic_C(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'C');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jchar result = env_->GetStaticCharField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_C(MemberKey key, jchar value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'C');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticCharField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jshort Class::GetStatic_S(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'S');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jshort result = env_->GetStaticShortField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_S(MemberKey key, jshort value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'S');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticShortField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jint Class::GetStatic_I(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'I');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jint result = env_->GetStaticIntField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_I(MemberKey key, jint value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'I');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticIntField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jlong Class::GetStatic_J(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'J');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jlong result = env_->GetStaticLongField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_J(MemberKey key, jlong value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'J');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticLongField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jfloat Class::GetStatic_F(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'F');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jfloat result = env_->GetStaticFloatField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_F(MemberKey key, jfloat value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'F');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticFloatField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jdouble Class::GetStatic_D(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'D');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jdouble result = env_->GetStaticDoubleField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        return result;
+    }
+
+    void Class::SetStatic_D(MemberKey key, jdouble value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'D');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticDoubleField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
+    jobject Class::GetStatic_L(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'L');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        jobject result = env_->GetStaticObjectField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+        RefMonitor::OnCreate(kLocalRef, result, "Class::GetStatic_L");
+        return result;
+    }
+
+    void Class::SetStatic_L(MemberKey key, jobject value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'L');
+        jfieldID field_id = GetFieldID(env_, val_, key, true);
+        env_->SetStaticObjectField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig, true);
+    }
+
 #pragma mark - Instance Method
 
     Class Class::GetSuperClass() {
-        return Class(env_, env_->GetSuperclass(val_));
+        jclass super_class = env_->GetSuperclass(val_);
+        RefMonitor::OnCreate(kLocalRef, super_class, "Class::GetSuperClass");
+        return Class(env_, super_class);
     }
 
     jobject Class::NewInstance(const char *constructor_sig, ...) {
+        NF_CHECK_CALL(env_, val_, "<init>", constructor_sig, 'V');
         jmethodID constructor = GetMethodID(env_, val_, "<init>", constructor_sig);
         va_list args;
         va_start(args, constructor_sig);
+        NF_CHECK_ARGUMENTS(env_, "<init>", constructor_sig, args);
         jobject result = env_->NewObjectV(val_, constructor, args);
         va_end(args);
         CheckCallMethodException(env_, "<init>", constructor_sig);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Class::NewInstance");
         return result;
     }
 
     jobject Class::NewInstanceV(const char *constructor_sig, va_list args) {
+        NF_CHECK_CALL(env_, val_, "<init>", constructor_sig, 'V');
+        NF_CHECK_ARGUMENTS(env_, "<init>", constructor_sig, args);
         jmethodID constructor = GetMethodID(env_, val_, "<init>", constructor_sig);
         jobject result = env_->NewObjectV(val_, constructor, args);
         va_end(args);
         CheckCallMethodException(env_, "<init>", constructor_sig);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Class::NewInstanceV");
         return result;
     }
+
+    ClassIndex Class::BuildIndex() {
+        return ClassIndex(env_, val_);
+    }
+
+    ConstantSnapshot Class::SnapshotConstants() {
+        return ConstantSnapshot(env_, val_);
+    }
+
+    const EnumBridge &Class::BridgeEnum() {
+        return EnumBridge::ForClass(env_, val_);
+    }
+
+    FieldBatch Class::NewFieldBatch() {
+        return FieldBatch(env_, val_);
+    }
+
+    FieldBatch Class::NewStaticFieldBatch() {
+        return FieldBatch(env_, val_, true);
+    }
 }
@@ -29,6 +29,10 @@
 
 #include "exception.h"
 #include "object.h"
+#include "class_index.h"
+#include "constants.h"
+#include "enum_bridge.h"
+#include "field_batch.h"
 
 namespace natiflect {
 
@@ -64,6 +68,24 @@ namespace natiflect {
 
         jobject CallStatic_L(const char *name, const char *sig, ...);
 
+#pragma mark - Static Method Returning Boxed Value
+
+        jboolean CallStaticUnboxed_Z(const char *name, const char *sig, ...);
+
+        jbyte CallStaticUnboxed_B(const char *name, const char *sig, ...);
+
+        jchar CallStaticUnboxed_C(const char *name, const char *sig, ...);
+
+        jshort CallStaticUnboxed_S(const char *name, const char *sig, ...);
+
+        jint CallStaticUnboxed_I(const char *name, const char *sig, ...);
+
+        jlong CallStaticUnboxed_J(const char *name, const char *sig, ...);
+
+        jfloat CallStaticUnboxed_F(const char *name, const char *sig, ...);
+
+        jdouble CallStaticUnboxed_D(const char *name, const char *sig, ...);
+
 #pragma mark - Static Field
 
         jboolean GetStatic_Z(const char *name);
@@ -102,6 +124,66 @@ namespace natiflect {
 
         void SetStatic_L(const char *name, const char *sig, jobject value);
 
+#pragma mark - Static Method With Member Key
+
+        void CallStatic_V(MemberKey key, ...);
+
+        jboolean CallStatic_Z(MemberKey key, ...);
+
+        jbyte CallStatic_B(MemberKey key, ...);
+
+        jchar CallStatic_C(MemberKey key, ...);
+
+        jshort CallStatic_S(MemberKey key, ...);
+
+        jint CallStatic_I(MemberKey key, ...);
+
+        jlong CallStatic_J(MemberKey key, ...);
+
+        jfloat CallStatic_F(MemberKey key, ...);
+
+        jdouble CallStatic_D(MemberKey key, ...);
+
+        jobject CallStatic_L(MemberKey key, ...);
+
+#pragma mark - Static Field With Member Key
+
+        jboolean GetStatic_Z(MemberKey key);
+
+        void SetStatic_Z(MemberKey key, jboolean value);
+
+        jbyte GetStatic_B(MemberKey key);
+
+        void SetStatic_B(MemberKey key, jbyte value);
+
+        jchar GetStatic_C(MemberKey key);
+
+        void SetStatic_C(MemberKey key, jchar value);
+
+        jshort GetStatic_S(MemberKey key);
+
+        void SetStatic_S(MemberKey key, jshort value);
+
+        jint GetStatic_I(MemberKey key);
+
+        void SetStatic_I(MemberKey key, jint value);
+
+        jlong GetStatic_J(MemberKey key);
+
+        void SetStatic_J(MemberKey key, jlong value);
+
+        jfloat GetStatic_F(MemberKey key);
+
+        void SetStatic_F(MemberKey key, jfloat value);
+
+        jdouble GetStatic_D(MemberKey key);
+
+        void SetStatic_D(MemberKey key, jdouble value);
+
+        jobject GetStatic_L(MemberKey key);
+
+        void SetStatic_L(MemberKey key, jobject value);
+
 #pragma mark - Instance Method
 
         Class GetSuperClass();
@@ -109,6 +191,18 @@ namespace natiflect {
         jobject NewInstance(const char *constructor_sig = "()V", ...);
 
         jobject NewInstanceV(const char *constructor_sig, va_list args);
+
+        ClassIndex BuildIndex();
+
+        ConstantSnapshot SnapshotConstants();
+
+        // Shared by all callers, see EnumBridge::ForClass.
+        const EnumBridge &BridgeEnum();
+
+        // A batch of writes to fields of instances of this class, see FieldBatch.
+        FieldBatch NewFieldBatch();
+
+        FieldBatch NewStaticFieldBatch();
     };
 }
 
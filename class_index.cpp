@@ -0,0 +1,389 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "class_index.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const jint kModifierStatic = 0x0008;
+
+        struct Reflection {
+            jmethodID class_get_name;
+            jmethodID class_get_declared_methods;
+            jmethodID class_get_declared_constructors;
+            jmethodID class_get_declared_fields;
+            jmethodID class_get_methods;
+            jmethodID method_get_name;
+            jmethodID method_get_parameter_types;
+            jmethodID method_get_return_type;
+            jmethodID method_get_modifiers;
+            jmethodID constructor_get_parameter_types;
+            jmethodID constructor_get_modifiers;
+            jmethodID field_get_name;
+            jmethodID field_get_type;
+            jmethodID field_get_modifiers;
+
+            Reflection(JNIEnv *env) {
+                LocalFrame frame(env, 4);
+                jclass clz_class = env->FindClass("java/lang/Class");
+                CheckNotFoundException(env, "class \"java/lang/Class\"");
+                jclass method_class = env->FindClass("java/lang/reflect/Method");
+                CheckNotFoundException(env, "class \"java/lang/reflect/Method\"");
+                jclass constructor_class = env->FindClass("java/lang/reflect/Constructor");
+                CheckNotFoundException(env, "class \"java/lang/reflect/Constructor\"");
+                jclass field_class = env->FindClass("java/lang/reflect/Field");
+                CheckNotFoundException(env, "class \"java/lang/reflect/Field\"");
+
+                class_get_name = GetMethodID(env, clz_class, "getName", "()Ljava/lang/String;");
+                class_get_declared_methods = GetMethodID(env, clz_class, "getDeclaredMethods",
+                                                         "()[Ljava/lang/reflect/Method;");
+                class_get_declared_constructors = GetMethodID(env, clz_class, "getDeclaredConstructors",
+                                                              "()[Ljava/lang/reflect/Constructor;");
+                class_get_declared_fields = GetMethodID(env, clz_class, "getDeclaredFields",
+                                                        "()[Ljava/lang/reflect/Field;");
+                class_get_methods = GetMethodID(env, clz_class, "getMethods", "()[Ljava/lang/reflect/Method;");
+                method_get_name = GetMethodID(env, method_class, "getName", "()Ljava/lang/String;");
+                method_get_parameter_types = GetMethodID(env, method_class, "getParameterTypes",
+                                                         "()[Ljava/lang/Class;");
+                method_get_return_type = GetMethodID(env, method_class, "getReturnType", "()Ljava/lang/Class;");
+                method_get_modifiers = GetMethodID(env, method_class, "getModifiers", "()I");
+                constructor_get_parameter_types = GetMethodID(env, constructor_class, "getParameterTypes",
+                                                              "()[Ljava/lang/Class;");
+                constructor_get_modifiers = GetMethodID(env, constructor_class, "getModifiers", "()I");
+                field_get_name = GetMethodID(env, field_class, "getName", "()Ljava/lang/String;");
+                field_get_type = GetMethodID(env, field_class, "getType", "()Ljava/lang/Class;");
+                field_get_modifiers = GetMethodID(env, field_class, "getModifiers", "()I");
+            }
+        };
+
+        jobject CallObject(JNIEnv *env, jobject obj, jmethodID method_id, const char *name, const char *sig) {
+            jobject result = env->CallObjectMethod(obj, method_id);
+            CheckCallMethodException(env, name, sig);
+            return result;
+        }
+
+        jint CallInt(JNIEnv *env, jobject obj, jmethodID method_id, const char *name) {
+            jint result = env->CallIntMethod(obj, method_id);
+            CheckCallMethodException(env, name, "()I");
+            return result;
+        }
+
+        string GetClassSignature(JNIEnv *env, const Reflection &refl, jclass type) {
+            jstring name = (jstring) CallObject(env, type, refl.class_get_name, "getName", "()Ljava/lang/String;");
+            string result = GetTypeSignature(GetStringUTF(env, name));
+            env->DeleteLocalRef(name);
+            return result;
+        }
+
+        string GetParameterSignature(JNIEnv *env, const Reflection &refl, jobject executable, jmethodID get_types) {
+            jobjectArray types = (jobjectArray) CallObject(env, executable, get_types, "getParameterTypes",
+                                                           "()[Ljava/lang/Class;");
+            string result = "(";
+            jsize length = env->GetArrayLength(types);
+            for (jsize i = 0; i < length; i++) {
+                jclass type = (jclass) env->GetObjectArrayElement(types, i);
+                result += GetClassSignature(env, refl, type);
+                env->DeleteLocalRef(type);
+            }
+            env->DeleteLocalRef(types);
+            return result + ")";
+        }
+
+        void AddMethod(JNIEnv *env, const Reflection &refl, jobject method,
+                       unordered_set<string> &seen, vector<ClassIndex::Method> &methods) {
+            LocalFrame frame(env, 8);
+            jstring name = (jstring) CallObject(env, method, refl.method_get_name, "getName",
+                                                "()Ljava/lang/String;");
+            ClassIndex::Method entry;
+            entry.name = GetStringUTF(env, name);
+            entry.sig = GetParameterSignature(env, refl, method, refl.method_get_parameter_types);
+            jclass return_type = (jclass) CallObject(env, method, refl.method_get_return_type, "getReturnType",
+                                                     "()Ljava/lang/Class;");
+            entry.sig += GetClassSignature(env, refl, return_type);
+            if (!seen.insert(entry.name + '\0' + entry.sig).second) {
+                // Overridden by a method found earlier in a subclass.
+                return;
+            }
+            entry.modifiers = CallInt(env, method, refl.method_get_modifiers, "getModifiers");
+            entry.is_static = (entry.modifiers & kModifierStatic) != 0;
+            entry.id = env->FromReflectedMethod(method);
+            methods.push_back(entry);
+        }
+
+        void AddConstructor(JNIEnv *env, const Reflection &refl, jobject constructor,
+                            vector<ClassIndex::Method> &methods) {
+            LocalFrame frame(env, 8);
+            ClassIndex::Method entry;
+            entry.name = "<init>";
+            entry.sig = GetParameterSignature(env, refl, constructor, refl.constructor_get_parameter_types) + "V";
+            entry.modifiers = CallInt(env, constructor, refl.constructor_get_modifiers, "getModifiers");
+            entry.is_static = false;
+            entry.id = env->FromReflectedMethod(constructor);
+            methods.push_back(entry);
+        }
+
+        void AddField(JNIEnv *env, const Reflection &refl, jobject field,
+                      unordered_set<string> &seen, vector<ClassIndex::Field> &fields) {
+            LocalFrame frame(env, 8);
+            jstring name = (jstring) CallObject(env, field, refl.field_get_name, "getName", "()Ljava/lang/String;");
+            jclass type = (jclass) CallObject(env, field, refl.field_get_type, "getType", "()Ljava/lang/Class;");
+            ClassIndex::Field entry;
+            entry.name = GetStringUTF(env, name);
+            entry.sig = GetClassSignature(env, refl, type);
+            if (!seen.insert(entry.name + '\0' + entry.sig).second) {
+                // Hidden by a field declared in a subclass.
+                return;
+            }
+            entry.modifiers = CallInt(env, field, refl.field_get_modifiers, "getModifiers");
+            entry.is_static = (entry.modifiers & kModifierStatic) != 0;
+            entry.id = env->FromReflectedField(field);
+            fields.push_back(entry);
+        }
+
+        jobjectArray GetMembers(JNIEnv *env, jclass clz, jmethodID method_id, const char *name, const char *sig) {
+            return (jobjectArray) CallObject(env, clz, method_id, name, sig);
+        }
+
+        template<typename M>
+        bool CompareMember(const M &a, const M &b) {
+            int result = a.name.compare(b.name);
+            return result < 0 || (result == 0 && a.sig < b.sig);
+        }
+
+        template<typename M>
+        vector<uint64_t> HashMembers(const vector<M> &members) {
+            vector<uint64_t> hashes;
+            hashes.reserve(members.size());
+            for (size_t i = 0; i < members.size(); i++) {
+                hashes.push_back(HashMember(members[i].name.c_str(), members[i].sig.c_str()));
+            }
+            return hashes;
+        }
+
+        template<typename M>
+        const M *FindMember(const vector<M> &members, int64_t index, const char *name, const char *sig) {
+            if (index < 0) {
+                return NULL;
+            }
+            const M &member = members[(size_t) index];
+            if (member.name != name || member.sig != sig) {
+                return NULL;
+            }
+            return &member;
+        }
+
+        template<typename M>
+        const M *SearchMember(const vector<M> &members, const char *name, const char *sig) {
+            M key;
+            key.name = name;
+            key.sig = sig;
+            typename vector<M>::const_iterator it = lower_bound(members.begin(), members.end(), key,
+                                                                CompareMember<M>);
+            if (it == members.end() || it->name != name || it->sig != sig) {
+                return NULL;
+            }
+            return &*it;
+        }
+
+        uint64_t Mix(uint64_t hash, uint32_t seed) {
+            // splitmix64 finalizer, seeded.
+            uint64_t x = hash + ((uint64_t) seed + 1) * 0x9E3779B97F4A7C15ULL;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+            return x ^ (x >> 31);
+        }
+    }
+
+#pragma mark - Public
+
+    ClassIndex::ClassIndex(JNIEnv *env, jclass clz) {
+        Reflection refl(env);
+        unordered_set<string> seen_methods;
+        unordered_set<string> seen_fields;
+
+        {
+            LocalFrame frame(env, 4);
+            jobjectArray constructors = GetMembers(env, clz, refl.class_get_declared_constructors,
+                                                   "getDeclaredConstructors", "()[Ljava/lang/reflect/Constructor;");
+            jsize length = env->GetArrayLength(constructors);
+            for (jsize i = 0; i < length; i++) {
+                jobject constructor = env->GetObjectArrayElement(constructors, i);
+                AddConstructor(env, refl, constructor, methods_);
+                env->DeleteLocalRef(constructor);
+            }
+        }
+
+        // Walk up from the class itself so that overriding and hiding members win, like GetMethodID/GetFieldID do.
+        jclass current = (jclass) env->NewLocalRef(clz);
+        while (current) {
+            {
+                LocalFrame frame(env, 4);
+                jobjectArray methods = GetMembers(env, current, refl.class_get_declared_methods,
+                                                  "getDeclaredMethods", "()[Ljava/lang/reflect/Method;");
+                jsize length = env->GetArrayLength(methods);
+                for (jsize i = 0; i < length; i++) {
+                    jobject method = env->GetObjectArrayElement(methods, i);
+                    AddMethod(env, refl, method, seen_methods, methods_);
+                    env->DeleteLocalRef(method);
+                }
+
+                jobjectArray fields = GetMembers(env, current, refl.class_get_declared_fields,
+                                                 "getDeclaredFields", "()[Ljava/lang/reflect/Field;");
+                length = env->GetArrayLength(fields);
+                for (jsize i = 0; i < length; i++) {
+                    jobject field = env->GetObjectArrayElement(fields, i);
+                    AddField(env, refl, field, seen_fields, fields_);
+                    env->DeleteLocalRef(field);
+                }
+            }
+
+            jclass super_clz = env->GetSuperclass(current);
+            env->DeleteLocalRef(current);
+            current = super_clz;
+        }
+
+        {
+            // Public methods inherited from interfaces (default and abstract ones) are only reachable this way.
+            LocalFrame frame(env, 4);
+            jobjectArray methods = GetMembers(env, clz, refl.class_get_methods, "getMethods",
+                                              "()[Ljava/lang/reflect/Method;");
+            jsize length = env->GetArrayLength(methods);
+            for (jsize i = 0; i < length; i++) {
+                jobject method = env->GetObjectArrayElement(methods, i);
+                AddMethod(env, refl, method, seen_methods, methods_);
+                env->DeleteLocalRef(method);
+            }
+        }
+
+        sort(methods_.begin(), methods_.end(), CompareMember<Method>);
+        sort(fields_.begin(), fields_.end(), CompareMember<Field>);
+        method_hash_.Build(HashMembers(methods_));
+        field_hash_.Build(HashMembers(fields_));
+    }
+
+    const ClassIndex::Method *ClassIndex::FindMethod(const char *name, const char *sig) const {
+        if (!method_hash_.IsValid()) {
+            return SearchMember(methods_, name, sig);
+        }
+        return FindMember(methods_, method_hash_.Find(HashMember(name, sig)), name, sig);
+    }
+
+    const ClassIndex::Field *ClassIndex::FindField(const char *name, const char *sig) const {
+        if (!field_hash_.IsValid()) {
+            return SearchMember(fields_, name, sig);
+        }
+        return FindMember(fields_, field_hash_.Find(HashMember(name, sig)), name, sig);
+    }
+
+    vector<const ClassIndex::Method *> ClassIndex::GetOverloads(const char *name) const {
+        vector<const Method *> result;
+        Method key;
+        key.name = name;
+        vector<Method>::const_iterator it = lower_bound(methods_.begin(), methods_.end(), key, CompareMember<Method>);
+        for (; it != methods_.end() && it->name == name; ++it) {
+            result.push_back(&*it);
+        }
+        return result;
+    }
+
+#pragma mark - Perfect Hash
+
+    void ClassIndex::PerfectHash::Build(const vector<uint64_t> &hashes) {
+        // Hash and displace: keys are split into buckets, and each bucket, largest first,
+        // gets the first seed that places all of its keys into free slots of a table
+        // exactly as large as the key set.
+        size_t size = hashes.size();
+        seeds_.clear();
+        slots_.clear();
+        valid_ = true;
+        if (size == 0) {
+            return;
+        }
+
+        size_t bucket_count = (size + 3) / 4;
+        vector<vector<uint32_t> > buckets(bucket_count);
+        for (size_t i = 0; i < size; i++) {
+            buckets[Mix(hashes[i], 0) % bucket_count].push_back((uint32_t) i);
+        }
+        vector<uint32_t> order(bucket_count);
+        for (size_t i = 0; i < bucket_count; i++) {
+            order[i] = (uint32_t) i;
+        }
+        stable_sort(order.begin(), order.end(), [&buckets](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        const uint32_t kEmpty = 0xFFFFFFFF;
+        const uint32_t kMaxSeed = 1 << 24;
+        seeds_.assign(bucket_count, 0);
+        slots_.assign(size, kEmpty);
+        vector<size_t> placed;
+        for (size_t i = 0; i < bucket_count; i++) {
+            const vector<uint32_t> &bucket = buckets[order[i]];
+            if (bucket.empty()) {
+                break;
+            }
+            uint32_t seed;
+            for (seed = 1; seed <= kMaxSeed; seed++) {
+                placed.clear();
+                bool ok = true;
+                for (size_t j = 0; j < bucket.size(); j++) {
+                    size_t slot = Mix(hashes[bucket[j]], seed) % size;
+                    if (slots_[slot] != kEmpty) {
+                        ok = false;
+                        break;
+                    }
+                    slots_[slot] = bucket[j];
+                    placed.push_back(slot);
+                }
+                if (ok) {
+                    seeds_[order[i]] = seed;
+                    break;
+                }
+                for (size_t j = 0; j < placed.size(); j++) {
+                    slots_[placed[j]] = kEmpty;
+                }
+            }
+            if (seed > kMaxSeed) {
+                // Only happens if two keys share the full 64-bit hash; callers fall back to binary search.
+                seeds_.clear();
+                slots_.clear();
+                valid_ = false;
+                return;
+            }
+        }
+    }
+
+    int64_t ClassIndex::PerfectHash::Find(uint64_t hash) const {
+        if (slots_.empty()) {
+            return -1;
+        }
+        uint32_t seed = seeds_[Mix(hash, 0) % seeds_.size()];
+        return slots_[Mix(hash, seed) % slots_.size()];
+    }
+}
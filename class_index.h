@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_CLASS_INDEX_H
+#define NATIFLECT_CLASS_INDEX_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "exception.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // An index of all methods, constructors and fields a class offers, including inherited ones.
+    // Members are enumerated once through reflection and looked up by (name, sig) through
+    // a minimal perfect hash, so resolving a member never goes through GetMethodID/GetFieldID.
+    // The IDs stay valid as long as the class is loaded.
+    class ClassIndex {
+    public:
+        struct Method {
+            string name;
+            string sig;
+            jint modifiers;
+            bool is_static;
+            jmethodID id;
+        };
+
+        struct Field {
+            string name;
+            string sig;
+            jint modifiers;
+            bool is_static;
+            jfieldID id;
+        };
+
+        ClassIndex() { };
+
+        ClassIndex(JNIEnv *env, jclass clz);
+
+        const Method *FindMethod(const char *name, const char *sig) const;
+
+        const Field *FindField(const char *name, const char *sig) const;
+
+        vector<const Method *> GetOverloads(const char *name) const;
+
+        const vector<Method> &GetMethods() const { return methods_; };
+
+        const vector<Field> &GetFields() const { return fields_; };
+
+    private:
+        class PerfectHash {
+        public:
+            PerfectHash() : valid_(true) { };
+
+            void Build(const vector<uint64_t> &hashes);
+
+            bool IsValid() const { return valid_; };
+
+            // Returns the only slot the hash could be stored in, or -1 if the table is empty.
+            int64_t Find(uint64_t hash) const;
+
+        private:
+            vector<uint32_t> seeds_;
+            vector<uint32_t> slots_;
+            bool valid_;
+        };
+
+        vector<Method> methods_;
+        vector<Field> fields_;
+        PerfectHash method_hash_;
+        PerfectHash field_hash_;
+    };
+}
+
+#endif //NATIFLECT_CLASS_INDEX_H
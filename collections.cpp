@@ -0,0 +1,177 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "collections.h"
+
+#include <mutex>
+
+#include "ref_monitor.h"
+
+namespace natiflect {
+
+    namespace {
+
+        struct Collections {
+            jclass object_clz;
+            jclass array_list_clz;
+            jclass hash_set_clz;
+            jclass hash_map_clz;
+            jclass arrays_clz;
+            jmethodID collection_to_array;
+            jmethodID map_entry_set;
+            jmethodID map_put;
+            jmethodID entry_get_key;
+            jmethodID entry_get_value;
+            jmethodID array_list_init;
+            jmethodID hash_set_init;
+            jmethodID hash_map_init;
+            jmethodID arrays_as_list;
+        };
+
+        Collections collections;
+        once_flag collections_once;
+
+        jclass FindClass(JNIEnv *env, const char *name) {
+            jclass clz = env->FindClass(name);
+            CheckNotFoundException(env, string("class \"") + name + "\"");
+            return clz;
+        }
+
+        jclass FindGlobalClass(JNIEnv *env, const char *name) {
+            jclass clz = FindClass(env, name);
+            jclass global = (jclass) env->NewGlobalRef(clz);
+            RefMonitor::OnCreate(kGlobalRef, global, "Collections");
+            env->DeleteLocalRef(clz);
+            return global;
+        }
+
+        void InitCollections(JNIEnv *env) {
+            LocalFrame frame(env, 4);
+            jclass collection_clz = FindClass(env, "java/util/Collection");
+            jclass map_clz = FindClass(env, "java/util/Map");
+            jclass entry_clz = FindClass(env, "java/util/Map$Entry");
+
+            Collections c;
+            c.collection_to_array = GetMethodID(env, collection_clz, "toArray", "()[Ljava/lang/Object;");
+            c.map_entry_set = GetMethodID(env, map_clz, "entrySet", "()Ljava/util/Set;");
+            c.map_put = GetMethodID(env, map_clz, "put",
+                                    "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+            c.entry_get_key = GetMethodID(env, entry_clz, "getKey", "()Ljava/lang/Object;");
+            c.entry_get_value = GetMethodID(env, entry_clz, "getValue", "()Ljava/lang/Object;");
+
+            c.object_clz = FindGlobalClass(env, "java/lang/Object");
+            c.array_list_clz = FindGlobalClass(env, "java/util/ArrayList");
+            c.hash_set_clz = FindGlobalClass(env, "java/util/HashSet");
+            c.hash_map_clz = FindGlobalClass(env, "java/util/HashMap");
+            c.arrays_clz = FindGlobalClass(env, "java/util/Arrays");
+            c.array_list_init = GetMethodID(env, c.array_list_clz, "<init>", "(Ljava/util/Collection;)V");
+            c.hash_set_init = GetMethodID(env, c.hash_set_clz, "<init>", "(Ljava/util/Collection;)V");
+            c.hash_map_init = GetMethodID(env, c.hash_map_clz, "<init>", "(I)V");
+            c.arrays_as_list = GetMethodID(env, c.arrays_clz, "asList", "([Ljava/lang/Object;)Ljava/util/List;", true);
+            collections = c;
+        }
+
+        const Collections &GetCollections(JNIEnv *env) {
+            call_once(collections_once, InitCollections, env);
+            return collections;
+        }
+
+        jobject NewCollectionFromArray(JNIEnv *env, jclass clz, jmethodID init, jobjectArray elements) {
+            const Collections &c = GetCollections(env);
+            // Arrays.asList only wraps the array, so the constructor copies it in one go.
+            jobject list = env->CallStaticObjectMethod(c.arrays_clz, c.arrays_as_list, elements);
+            CheckCallMethodException(env, "asList", "([Ljava/lang/Object;)Ljava/util/List;", true);
+            jobject result = env->NewObject(clz, init, list);
+            env->DeleteLocalRef(list);
+            CheckCallMethodException(env, "<init>", "(Ljava/util/Collection;)V");
+            return result;
+        }
+    }
+
+#pragma mark - Bulk Helpers
+
+    jobjectArray CollectionToArray(JNIEnv *env, jobject collection) {
+        const Collections &c = GetCollections(env);
+        jobjectArray result = (jobjectArray) env->CallObjectMethod(collection, c.collection_to_array);
+        CheckCallMethodException(env, "toArray", "()[Ljava/lang/Object;");
+        return result;
+    }
+
+    jobjectArray MapToEntryArray(JNIEnv *env, jobject map) {
+        const Collections &c = GetCollections(env);
+        jobject entry_set = env->CallObjectMethod(map, c.map_entry_set);
+        CheckCallMethodException(env, "entrySet", "()Ljava/util/Set;");
+        jobjectArray result = (jobjectArray) env->CallObjectMethod(entry_set, c.collection_to_array);
+        env->DeleteLocalRef(entry_set);
+        CheckCallMethodException(env, "toArray", "()[Ljava/lang/Object;");
+        return result;
+    }
+
+    jobject GetEntryKey(JNIEnv *env, jobject entry) {
+        const Collections &c = GetCollections(env);
+        jobject result = env->CallObjectMethod(entry, c.entry_get_key);
+        CheckCallMethodException(env, "getKey", "()Ljava/lang/Object;");
+        return result;
+    }
+
+    jobject GetEntryValue(JNIEnv *env, jobject entry) {
+        const Collections &c = GetCollections(env);
+        jobject result = env->CallObjectMethod(entry, c.entry_get_value);
+        CheckCallMethodException(env, "getValue", "()Ljava/lang/Object;");
+        return result;
+    }
+
+    jobjectArray NewObjectArray(JNIEnv *env, jsize length) {
+        const Collections &c = GetCollections(env);
+        jobjectArray result = env->NewObjectArray(length, c.object_clz, NULL);
+        if (!result) {
+            env->ExceptionClear();
+            throw Exception("Cannot allocate an object array.");
+        }
+        return result;
+    }
+
+    jobject NewArrayList(JNIEnv *env, jobjectArray elements) {
+        const Collections &c = GetCollections(env);
+        return NewCollectionFromArray(env, c.array_list_clz, c.array_list_init, elements);
+    }
+
+    jobject NewHashSet(JNIEnv *env, jobjectArray elements) {
+        const Collections &c = GetCollections(env);
+        return NewCollectionFromArray(env, c.hash_set_clz, c.hash_set_init, elements);
+    }
+
+    jobject NewHashMap(JNIEnv *env, jsize expected_size) {
+        const Collections &c = GetCollections(env);
+        // Sized so that expected_size entries fit under the default load factor without rehashing.
+        jint capacity = (jint) ((jlong) expected_size * 4 / 3 + 1);
+        jobject result = env->NewObject(c.hash_map_clz, c.hash_map_init, capacity);
+        CheckCallMethodException(env, "<init>", "(I)V");
+        return result;
+    }
+
+    void PutToMap(JNIEnv *env, jobject map, jobject key, jobject value) {
+        const Collections &c = GetCollections(env);
+        jobject previous = env->CallObjectMethod(map, c.map_put, key, value);
+        CheckCallMethodException(env, "put", "(Ljava/lang/Object;Ljava/lang/Object;)Ljava/lang/Object;");
+        env->DeleteLocalRef(previous);
+    }
+}
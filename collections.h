@@ -0,0 +1,282 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_COLLECTIONS_H
+#define NATIFLECT_COLLECTIONS_H
+
+#include <jni.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "exception.h"
+#include "array_traits.h"
+#include "boxing.h"
+#include "utils.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // Converters between java.util collections and native containers. Collections are transferred
+    // in bulk through toArray() and walked in chunks of local frames, so the local reference table
+    // stays bounded however large the collection is. All classes and method IDs are resolved once.
+
+    // Number of elements handled per local frame.
+    const jsize kCollectionChunkSize = 512;
+
+    // Converts single elements. Specialize it, or pass any object with the same two members
+    // to the functions below, to plug in other element types. ToJava must return a local reference.
+    template<typename E>
+    struct ElementConverter;
+
+    template<>
+    struct ElementConverter<jboolean> {
+        jboolean FromJava(JNIEnv *env, jobject obj) const { return Unbox_Z(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jboolean value) const { return Box_Z(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jbyte> {
+        jbyte FromJava(JNIEnv *env, jobject obj) const { return Unbox_B(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jbyte value) const { return Box_B(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jchar> {
+        jchar FromJava(JNIEnv *env, jobject obj) const { return Unbox_C(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jchar value) const { return Box_C(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jshort> {
+        jshort FromJava(JNIEnv *env, jobject obj) const { return Unbox_S(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jshort value) const { return Box_S(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jint> {
+        jint FromJava(JNIEnv *env, jobject obj) const { return Unbox_I(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jint value) const { return Box_I(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jlong> {
+        jlong FromJava(JNIEnv *env, jobject obj) const { return Unbox_J(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jlong value) const { return Box_J(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jfloat> {
+        jfloat FromJava(JNIEnv *env, jobject obj) const { return Unbox_F(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jfloat value) const { return Box_F(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<jdouble> {
+        jdouble FromJava(JNIEnv *env, jobject obj) const { return Unbox_D(env, obj); };
+
+        jobject ToJava(JNIEnv *env, jdouble value) const { return Box_D(env, value); };
+    };
+
+    template<>
+    struct ElementConverter<string> {
+        string FromJava(JNIEnv *env, jobject obj) const { return GetStringUTF(env, (jstring) obj); };
+
+        jobject ToJava(JNIEnv *env, const string &value) const { return env->NewStringUTF(value.c_str()); };
+    };
+
+#pragma mark - Bulk Helpers
+
+    jobjectArray CollectionToArray(JNIEnv *env, jobject collection);
+
+    jobjectArray MapToEntryArray(JNIEnv *env, jobject map);
+
+    jobject GetEntryKey(JNIEnv *env, jobject entry);
+
+    jobject GetEntryValue(JNIEnv *env, jobject entry);
+
+    jobjectArray NewObjectArray(JNIEnv *env, jsize length);
+
+    jobject NewArrayList(JNIEnv *env, jobjectArray elements);
+
+    jobject NewHashSet(JNIEnv *env, jobjectArray elements);
+
+    jobject NewHashMap(JNIEnv *env, jsize expected_size);
+
+    void PutToMap(JNIEnv *env, jobject map, jobject key, jobject value);
+
+#pragma mark - Java To Native
+
+    template<typename E, typename Converter>
+    vector<E> ToVector(JNIEnv *env, jobject collection, const Converter &converter) {
+        jobjectArray elements = CollectionToArray(env, collection);
+        jsize length = env->GetArrayLength(elements);
+        vector<E> result;
+        result.reserve((size_t) length);
+        for (jsize start = 0; start < length; start += kCollectionChunkSize) {
+            LocalFrame frame(env, kCollectionChunkSize);
+            jsize end = length - start < kCollectionChunkSize ? length : start + kCollectionChunkSize;
+            for (jsize i = start; i < end; i++) {
+                jobject element = env->GetObjectArrayElement(elements, i);
+                result.push_back(converter.FromJava(env, element));
+                env->DeleteLocalRef(element);
+            }
+        }
+        env->DeleteLocalRef(elements);
+        return result;
+    }
+
+    template<typename E>
+    vector<E> ToVector(JNIEnv *env, jobject collection) {
+        return ToVector<E>(env, collection, ElementConverter<E>());
+    }
+
+    // Copies a primitive Java array with a single region transfer.
+    template<typename E>
+    vector<E> ToVector(JNIEnv *env, typename ArrayTraits<E>::ArrayType array) {
+        jsize length = env->GetArrayLength(array);
+        vector<E> result((size_t) length);
+        if (length > 0) {
+            ArrayTraits<E>::GetRegion(env, array, 0, length, &result[0]);
+        }
+        return result;
+    }
+
+    template<typename K, typename V, typename KeyConverter, typename ValueConverter>
+    unordered_map<K, V> ToUnorderedMap(JNIEnv *env, jobject map, const KeyConverter &key_converter,
+                                       const ValueConverter &value_converter) {
+        jobjectArray entries = MapToEntryArray(env, map);
+        jsize length = env->GetArrayLength(entries);
+        unordered_map<K, V> result((size_t) length);
+        for (jsize start = 0; start < length; start += kCollectionChunkSize) {
+            LocalFrame frame(env, kCollectionChunkSize);
+            jsize end = length - start < kCollectionChunkSize ? length : start + kCollectionChunkSize;
+            for (jsize i = start; i < end; i++) {
+                jobject entry = env->GetObjectArrayElement(entries, i);
+                jobject key = GetEntryKey(env, entry);
+                jobject value = GetEntryValue(env, entry);
+                result[key_converter.FromJava(env, key)] = value_converter.FromJava(env, value);
+                env->DeleteLocalRef(value);
+                env->DeleteLocalRef(key);
+                env->DeleteLocalRef(entry);
+            }
+        }
+        env->DeleteLocalRef(entries);
+        return result;
+    }
+
+    template<typename K, typename V>
+    unordered_map<K, V> ToUnorderedMap(JNIEnv *env, jobject map) {
+        return ToUnorderedMap<K, V>(env, map, ElementConverter<K>(), ElementConverter<V>());
+    }
+
+#pragma mark - Native To Java
+
+    template<typename E, typename Converter>
+    jobjectArray ToObjectArray(JNIEnv *env, const vector<E> &elements, const Converter &converter) {
+        jsize length = (jsize) elements.size();
+        jobjectArray result = NewObjectArray(env, length);
+        for (jsize start = 0; start < length; start += kCollectionChunkSize) {
+            LocalFrame frame(env, kCollectionChunkSize);
+            jsize end = length - start < kCollectionChunkSize ? length : start + kCollectionChunkSize;
+            for (jsize i = start; i < end; i++) {
+                jobject element = converter.ToJava(env, elements[(size_t) i]);
+                env->SetObjectArrayElement(result, i, element);
+                env->DeleteLocalRef(element);
+            }
+        }
+        return result;
+    }
+
+    template<typename E, typename Converter>
+    jobject NewList(JNIEnv *env, const vector<E> &elements, const Converter &converter) {
+        jobjectArray array = ToObjectArray(env, elements, converter);
+        jobject result = NewArrayList(env, array);
+        env->DeleteLocalRef(array);
+        return result;
+    }
+
+    template<typename E>
+    jobject NewList(JNIEnv *env, const vector<E> &elements) {
+        return NewList(env, elements, ElementConverter<E>());
+    }
+
+    template<typename E, typename Converter>
+    jobject NewSet(JNIEnv *env, const vector<E> &elements, const Converter &converter) {
+        jobjectArray array = ToObjectArray(env, elements, converter);
+        jobject result = NewHashSet(env, array);
+        env->DeleteLocalRef(array);
+        return result;
+    }
+
+    template<typename E>
+    jobject NewSet(JNIEnv *env, const vector<E> &elements) {
+        return NewSet(env, elements, ElementConverter<E>());
+    }
+
+    // Copies into a new primitive Java array with a single region transfer.
+    template<typename E>
+    typename ArrayTraits<E>::ArrayType NewPrimitiveArray(JNIEnv *env, const vector<E> &elements) {
+        jsize length = (jsize) elements.size();
+        typename ArrayTraits<E>::ArrayType result = ArrayTraits<E>::NewArray(env, length);
+        if (!result) {
+            env->ExceptionClear();
+            throw Exception("Cannot allocate a primitive array.");
+        }
+        if (length > 0) {
+            ArrayTraits<E>::SetRegion(env, result, 0, length, &elements[0]);
+        }
+        return result;
+    }
+
+    template<typename K, typename V, typename KeyConverter, typename ValueConverter>
+    jobject NewMap(JNIEnv *env, const unordered_map<K, V> &map, const KeyConverter &key_converter,
+                   const ValueConverter &value_converter) {
+        jobject result = NewHashMap(env, (jsize) map.size());
+        typename unordered_map<K, V>::const_iterator it = map.begin();
+        while (it != map.end()) {
+            LocalFrame frame(env, kCollectionChunkSize);
+            for (jsize i = 0; i < kCollectionChunkSize && it != map.end(); i++, ++it) {
+                jobject key = key_converter.ToJava(env, it->first);
+                jobject value = value_converter.ToJava(env, it->second);
+                PutToMap(env, result, key, value);
+                env->DeleteLocalRef(value);
+                env->DeleteLocalRef(key);
+            }
+        }
+        return result;
+    }
+
+    template<typename K, typename V>
+    jobject NewMap(JNIEnv *env, const unordered_map<K, V> &map) {
+        return NewMap(env, map, ElementConverter<K>(), ElementConverter<V>());
+    }
+}
+
+#endif //NATIFLECT_COLLECTIONS_H
@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "constants.h"
+
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const jint kModifierStatic = 0x0008;
+        const jint kModifierFinal = 0x0010;
+    }
+
+#pragma mark - Public
+
+    ConstantSnapshot::ConstantSnapshot(JNIEnv *env, jclass clz) {
+        env->GetJavaVM(&vm_);
+        clz_ = (jclass) env->NewGlobalRef(clz);
+        RefMonitor::OnCreate(kGlobalRef, clz_, "ConstantSnapshot");
+
+        try {
+            LocalFrame frame(env, 8);
+            jclass clz_class = env->FindClass("java/lang/Class");
+            CheckNotFoundException(env, "class \"java/lang/Class\"");
+            jclass field_class = env->FindClass("java/lang/reflect/Field");
+            CheckNotFoundException(env, "class \"java/lang/reflect/Field\"");
+            jmethodID get_declared_fields = GetMethodID(env, clz_class, "getDeclaredFields",
+                                                        "()[Ljava/lang/reflect/Field;");
+            jmethodID get_name = GetMethodID(env, field_class, "getName", "()Ljava/lang/String;");
+            jmethodID get_type = GetMethodID(env, field_class, "getType", "()Ljava/lang/Class;");
+            jmethodID get_modifiers = GetMethodID(env, field_class, "getModifiers", "()I");
+
+            jobjectArray fields = (jobjectArray) env->CallObjectMethod(clz, get_declared_fields);
+            CheckCallMethodException(env, "getDeclaredFields", "()[Ljava/lang/reflect/Field;");
+            jsize length = env->GetArrayLength(fields);
+            for (jsize i = 0; i < length; i++) {
+                LocalFrame field_frame(env, 4);
+                jobject field = env->GetObjectArrayElement(fields, i);
+                jint modifiers = env->CallIntMethod(field, get_modifiers);
+                CheckCallMethodException(env, "getModifiers", "()I");
+                if ((modifiers & (kModifierStatic | kModifierFinal)) != (kModifierStatic | kModifierFinal)) {
+                    continue;
+                }
+                jstring name = (jstring) env->CallObjectMethod(field, get_name);
+                CheckCallMethodException(env, "getName", "()Ljava/lang/String;");
+                jclass type = (jclass) env->CallObjectMethod(field, get_type);
+                CheckCallMethodException(env, "getType", "()Ljava/lang/Class;");
+
+                string name_str = GetStringUTF(env, name);
+                Constant constant;
+                constant.sig = GetTypeSignature(GetClassName(env, type));
+                constant.value.j = 0;
+                constant.tracked = false;
+                Read(env, constant, name_str.c_str());
+                constants_[name_str] = constant;
+            }
+        } catch (...) {
+            Release(env);
+            throw;
+        }
+    }
+
+    ConstantSnapshot::ConstantSnapshot(ConstantSnapshot &&other) : vm_(other.vm_), clz_(other.clz_) {
+        constants_.swap(other.constants_);
+        other.clz_ = NULL;
+    }
+
+    ConstantSnapshot::~ConstantSnapshot() {
+        JNIEnv *env = GetAttachedEnv(vm_);
+        if (env) {
+            Release(env);
+        }
+    }
+
+    bool ConstantSnapshot::Contains(const char *name) const {
+        return constants_.find(name) != constants_.end();
+    }
+
+    jboolean ConstantSnapshot::Get_Z(const char *name) const {
+        return Find(name, 'Z').value.z;
+    }
+
+    jbyte ConstantSnapshot::Get_B(const char *name) const {
+        return Find(name, 'B').value.b;
+    }
+
+    jchar ConstantSnapshot::Get_C(const char *name) const {
+        return Find(name, 'C').value.c;
+    }
+
+    jshort ConstantSnapshot::Get_S(const char *name) const {
+        return Find(name, 'S').value.s;
+    }
+
+    jint ConstantSnapshot::Get_I(const char *name) const {
+        return Find(name, 'I').value.i;
+    }
+
+    jlong ConstantSnapshot::Get_J(const char *name) const {
+        return Find(name, 'J').value.j;
+    }
+
+    jfloat ConstantSnapshot::Get_F(const char *name) const {
+        return Find(name, 'F').value.f;
+    }
+
+    jdouble ConstantSnapshot::Get_D(const char *name) const {
+        return Find(name, 'D').value.d;
+    }
+
+    jobject ConstantSnapshot::Get_L(const char *name) const {
+        return Find(name, 'L').value.l;
+    }
+
+    void ConstantSnapshot::Track(JNIEnv *env, const char *name, const char *sig) {
+        Constant constant;
+        unordered_map<string, Constant>::iterator it = constants_.find(name);
+        if (it == constants_.end()) {
+            constant.sig = sig;
+            constant.value.j = 0;
+        } else if (it->second.sig != sig) {
+            throw AccessException(string("Field \"") + name + "\" does not have signature \"" + sig + "\".");
+        } else {
+            constant = it->second;
+        }
+        constant.tracked = true;
+        // Only added once the field has been resolved and read.
+        Read(env, constant, name);
+        constants_[name] = constant;
+    }
+
+    void ConstantSnapshot::Refresh(JNIEnv *env) {
+        for (unordered_map<string, Constant>::iterator it = constants_.begin(); it != constants_.end(); ++it) {
+            if (it->second.tracked) {
+                Read(env, it->second, it->first.c_str());
+            }
+        }
+    }
+
+    void ConstantSnapshot::Release(JNIEnv *env) {
+        for (unordered_map<string, Constant>::iterator it = constants_.begin(); it != constants_.end(); ++it) {
+            char type = it->second.sig[0];
+            if ((type == 'L' || type == '[') && it->second.value.l) {
+                RefMonitor::OnDelete(kGlobalRef, it->second.value.l, "ConstantSnapshot");
+                env->DeleteGlobalRef(it->second.value.l);
+            }
+        }
+        constants_.clear();
+        if (clz_) {
+            RefMonitor::OnDelete(kGlobalRef, clz_, "ConstantSnapshot");
+            env->DeleteGlobalRef(clz_);
+            clz_ = NULL;
+        }
+    }
+
+#pragma mark - Private
+
+    const ConstantSnapshot::Constant &ConstantSnapshot::Find(const char *name, char type) const {
+        unordered_map<string, Constant>::const_iterator it = constants_.find(name);
+        if (it == constants_.end()) {
+            throw NotFoundException(string("Cannot find constant \"") + name + "\".");
+        }
+        char sig_type = it->second.sig[0] == '[' ? 'L' : it->second.sig[0];
+        if (sig_type != type) {
+            throw AccessException(string("Constant \"") + name + "\" has signature \"" + it->second.sig + "\".");
+        }
+        return it->second;
+    }
+
+    void ConstantSnapshot::Read(JNIEnv *env, Constant &constant, const char *name) {
+        const char *sig = constant.sig.c_str();
+        // Going through GetFieldID makes sure the class is initialized before reading.
+        constant.id = GetFieldID(env, clz_, name, sig, true);
+        switch (sig[0]) {
+            case 'Z':
+                constant.value.z = env->GetStaticBooleanField(clz_, constant.id);
+                break;
+            case 'B':
+                constant.value.b = env->GetStaticByteField(clz_, constant.id);
+                break;
+            case 'C':
+                constant.value.c = env->GetStaticCharField(clz_, constant.id);
+                break;
+            case 'S':
+                constant.value.s = env->GetStaticShortField(clz_, constant.id);
+                break;
+            case 'I':
+                constant.value.i = env->GetStaticIntField(clz_, constant.id);
+                break;
+            case 'J':
+                constant.value.j = env->GetStaticLongField(clz_, constant.id);
+                break;
+            case 'F':
+                constant.value.f = env->GetStaticFloatField(clz_, constant.id);
+                break;
+            case 'D':
+                constant.value.d = env->GetStaticDoubleField(clz_, constant.id);
+                break;
+            default: {
+                jobject value = env->GetStaticObjectField(clz_, constant.id);
+                CheckAccessFieldException(env, name, sig, true);
+                if (constant.value.l) {
+                    RefMonitor::OnDelete(kGlobalRef, constant.value.l, "ConstantSnapshot");
+                    env->DeleteGlobalRef(constant.value.l);
+                }
+                constant.value.l = value ? env->NewGlobalRef(value) : NULL;
+                RefMonitor::OnCreate(kGlobalRef, constant.value.l, "ConstantSnapshot");
+                env->DeleteLocalRef(value);
+                return;
+            }
+        }
+        CheckAccessFieldException(env, name, sig, true);
+    }
+}
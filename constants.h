@@ -0,0 +1,98 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_CONSTANTS_H
+#define NATIFLECT_CONSTANTS_H
+
+#include <jni.h>
+#include <string>
+#include <unordered_map>
+
+#include "exception.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // A snapshot of the static final fields declared by a class, read once and served from native memory.
+    // Object constants are held as global references owned by the snapshot. Non-final statics that are
+    // read-mostly can be added with Track(), and are re-read on Refresh().
+    class ConstantSnapshot {
+    public:
+        ConstantSnapshot(JNIEnv *env, jclass clz);
+
+        ConstantSnapshot(ConstantSnapshot &&other);
+
+        ~ConstantSnapshot();
+
+        bool Contains(const char *name) const;
+
+        jboolean Get_Z(const char *name) const;
+
+        jbyte Get_B(const char *name) const;
+
+        jchar Get_C(const char *name) const;
+
+        jshort Get_S(const char *name) const;
+
+        jint Get_I(const char *name) const;
+
+        jlong Get_J(const char *name) const;
+
+        jfloat Get_F(const char *name) const;
+
+        jdouble Get_D(const char *name) const;
+
+        // The returned reference is owned by the snapshot and must not be deleted.
+        jobject Get_L(const char *name) const;
+
+        void Track(JNIEnv *env, const char *name, const char *sig);
+
+        // Re-reads the fields added with Track().
+        void Refresh(JNIEnv *env);
+
+        // Deletes the global references now. Otherwise this happens on destruction,
+        // if the destroying thread is attached to the VM.
+        void Release(JNIEnv *env);
+
+    private:
+        struct Constant {
+            string sig;
+            jfieldID id;
+            jvalue value;
+            bool tracked;
+        };
+
+        ConstantSnapshot(const ConstantSnapshot &);
+
+        ConstantSnapshot &operator=(const ConstantSnapshot &);
+
+        const Constant &Find(const char *name, char type) const;
+
+        void Read(JNIEnv *env, Constant &constant, const char *name);
+
+        JavaVM *vm_;
+        jclass clz_;
+        unordered_map<string, Constant> constants_;
+    };
+}
+
+#endif //NATIFLECT_CONSTANTS_H
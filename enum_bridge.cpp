@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "enum_bridge.h"
+
+#include <mutex>
+
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        struct CachedBridge {
+            jweak clz;
+            EnumBridge *bridge;
+        };
+
+        // Keyed by class name; classes of the same name from different loaders share a bucket.
+        mutex bridges_mutex;
+        unordered_multimap<string, CachedBridge> bridges;
+        // Bridges of unloaded classes. They hold nothing alive, but references to them may still be held.
+        vector<EnumBridge *> unloaded_bridges;
+    }
+
+    EnumBridge::EnumBridge(JNIEnv *env, jclass clz) : EnumBridge(env, clz, false) {
+    }
+
+    EnumBridge::EnumBridge(JNIEnv *env, jclass clz, bool weak) : weak_(weak) {
+        env->GetJavaVM(&vm_);
+
+        LocalFrame frame(env, 8);
+        jclass clz_class = env->FindClass("java/lang/Class");
+        CheckNotFoundException(env, "class \"java/lang/Class\"");
+        jclass enum_class = env->FindClass("java/lang/Enum");
+        CheckNotFoundException(env, "class \"java/lang/Enum\"");
+        if (!env->IsAssignableFrom(clz, enum_class)) {
+            throw InvokeException("Class \"" + GetClassName(env, clz) + "\" is not an enum.");
+        }
+        jmethodID get_enum_constants = GetMethodID(env, clz_class, "getEnumConstants", "()[Ljava/lang/Object;");
+        jmethodID name = GetMethodID(env, enum_class, "name", "()Ljava/lang/String;");
+        ordinal_ = GetMethodID(env, enum_class, "ordinal", "()I");
+
+        jobjectArray constants = (jobjectArray) env->CallObjectMethod(clz, get_enum_constants);
+        CheckCallMethodException(env, "getEnumConstants", "()[Ljava/lang/Object;");
+        if (!constants) {
+            // E.g. the class of a constant with a body, which extends the enum.
+            throw InvokeException("Class \"" + GetClassName(env, clz) + "\" is not an enum.");
+        }
+        jsize count = env->GetArrayLength(constants);
+        constants_.reserve((size_t) count);
+        names_.reserve((size_t) count);
+        try {
+            for (jsize i = 0; i < count; i++) {
+                // getEnumConstants() returns the constants in ordinal order.
+                jobject constant = env->GetObjectArrayElement(constants, i);
+                jstring constant_name = (jstring) env->CallObjectMethod(constant, name);
+                CheckCallMethodException(env, "name", "()Ljava/lang/String;");
+                names_.push_back(GetStringUTF(env, constant_name));
+                ordinals_[names_.back()] = i;
+                constants_.push_back(weak_ ? env->NewWeakGlobalRef(constant) : env->NewGlobalRef(constant));
+                RefMonitor::OnCreate(weak_ ? kWeakGlobalRef : kGlobalRef, constants_.back(), "EnumBridge");
+                env->DeleteLocalRef(constant_name);
+                env->DeleteLocalRef(constant);
+            }
+        } catch (...) {
+            Release(env);
+            throw;
+        }
+    }
+
+    const EnumBridge &EnumBridge::ForClass(JNIEnv *env, jclass clz) {
+        string class_name = GetClassName(env, clz);
+        {
+            lock_guard<mutex> lock(bridges_mutex);
+            pair<unordered_multimap<string, CachedBridge>::iterator,
+                    unordered_multimap<string, CachedBridge>::iterator> range = bridges.equal_range(class_name);
+            for (unordered_multimap<string, CachedBridge>::iterator it = range.first; it != range.second;) {
+                if (env->IsSameObject(it->second.clz, clz)) {
+                    return *it->second.bridge;
+                }
+                if (env->IsSameObject(it->second.clz, NULL)) {
+                    // Typically the class before a plugin was reloaded. Its weak references are left
+                    // alone, since other threads may still be using the bridge.
+                    unloaded_bridges.push_back(it->second.bridge);
+                    it = bridges.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        // Built without the lock, since building calls into Java.
+        EnumBridge *bridge = new EnumBridge(env, clz, true);
+        lock_guard<mutex> lock(bridges_mutex);
+        pair<unordered_multimap<string, CachedBridge>::iterator,
+                unordered_multimap<string, CachedBridge>::iterator> range = bridges.equal_range(class_name);
+        for (unordered_multimap<string, CachedBridge>::iterator it = range.first; it != range.second; ++it) {
+            if (env->IsSameObject(it->second.clz, clz)) {
+                // Another thread got here first.
+                bridge->Release(env);
+                delete bridge;
+                return *it->second.bridge;
+            }
+        }
+        CachedBridge cached;
+        cached.clz = env->NewWeakGlobalRef(clz);
+        if (!cached.clz) {
+            env->ExceptionClear();
+            bridge->Release(env);
+            delete bridge;
+            throw Exception("Cannot create a weak global reference to class \"" + class_name + "\".");
+        }
+        RefMonitor::OnCreate(kWeakGlobalRef, cached.clz, "EnumBridge");
+        cached.bridge = bridge;
+        bridges.insert(make_pair(class_name, cached));
+        return *bridge;
+    }
+
+    EnumBridge::EnumBridge(EnumBridge &&other) : vm_(other.vm_), ordinal_(other.ordinal_), weak_(other.weak_) {
+        constants_.swap(other.constants_);
+        names_.swap(other.names_);
+        ordinals_.swap(other.ordinals_);
+    }
+
+    EnumBridge::~EnumBridge() {
+        if (constants_.empty()) {
+            return;
+        }
+        JNIEnv *env = GetAttachedEnv(vm_);
+        if (env) {
+            Release(env);
+        }
+    }
+
+    jobject EnumBridge::Get(jint ordinal) const {
+        if (ordinal < 0 || ordinal >= (jint) constants_.size()) {
+            throw NotFoundException("Cannot find enum constant with ordinal " + to_string(ordinal) + ".");
+        }
+        return constants_[ordinal];
+    }
+
+    jobject EnumBridge::Get(const char *name) const {
+        return Get(GetOrdinal(name));
+    }
+
+    jint EnumBridge::GetOrdinal(JNIEnv *env, jobject constant) const {
+        if (!constant) {
+            throw InvokeException("Cannot get the ordinal of a null enum constant.");
+        }
+        jint ordinal = env->CallIntMethod(constant, ordinal_);
+        CheckCallMethodException(env, "ordinal", "()I");
+        if (ordinal < 0 || ordinal >= (jint) constants_.size()
+            || !env->IsSameObject(constants_[ordinal], constant)) {
+            throw InvokeException("The object is not a constant of this enum.");
+        }
+        return ordinal;
+    }
+
+    jint EnumBridge::GetOrdinal(const char *name) const {
+        unordered_map<string, jint>::const_iterator it = ordinals_.find(name);
+        if (it == ordinals_.end()) {
+            throw NotFoundException(string("Cannot find enum constant \"") + name + "\".");
+        }
+        return it->second;
+    }
+
+    const string &EnumBridge::GetName(jint ordinal) const {
+        if (ordinal < 0 || ordinal >= (jint) names_.size()) {
+            throw NotFoundException("Cannot find enum constant with ordinal " + to_string(ordinal) + ".");
+        }
+        return names_[ordinal];
+    }
+
+    void EnumBridge::Release(JNIEnv *env) {
+        for (size_t i = 0; i < constants_.size(); i++) {
+            if (weak_) {
+                RefMonitor::OnDelete(kWeakGlobalRef, constants_[i], "EnumBridge");
+                env->DeleteWeakGlobalRef(constants_[i]);
+            } else {
+                RefMonitor::OnDelete(kGlobalRef, constants_[i], "EnumBridge");
+                env->DeleteGlobalRef(constants_[i]);
+            }
+        }
+        constants_.clear();
+    }
+}
@@ -0,0 +1,99 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_ENUM_BRIDGE_H
+#define NATIFLECT_ENUM_BRIDGE_H
+
+#include <jni.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "exception.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // The constants of a Java enum, read once into a table indexed by ordinal, with their names. Mapping
+    // an ordinal or a name to a constant is a lookup, and a constant to its ordinal is one call to the
+    // cached ordinal() method. Constants are global references owned by the bridge. Once built, a bridge
+    // may be used from any thread.
+    class EnumBridge {
+    public:
+        EnumBridge(JNIEnv *env, jclass clz);
+
+        // Returns the bridge of clz, built on first use and shared for the rest of the process. It holds
+        // the constants through weak global references, which stay valid as long as the enum class is
+        // loaded, so that caching never keeps the class or its loader alive. Once the class is unloaded,
+        // the bridge holds nothing alive and its constants read as null.
+        static const EnumBridge &ForClass(JNIEnv *env, jclass clz);
+
+        EnumBridge(EnumBridge &&other);
+
+        ~EnumBridge();
+
+        jint GetCount() const { return (jint) constants_.size(); };
+
+        // The returned reference is owned by the bridge and must not be deleted. It is a weak global
+        // reference for bridges returned by ForClass.
+        jobject Get(jint ordinal) const;
+
+        jobject Get(const char *name) const;
+
+        jint GetOrdinal(JNIEnv *env, jobject constant) const;
+
+        jint GetOrdinal(const char *name) const;
+
+        const string &GetName(jint ordinal) const;
+
+        // For C++ enums declared in the same order as the Java enum.
+        template<typename E>
+        E ToNative(JNIEnv *env, jobject constant) const {
+            return static_cast<E>(GetOrdinal(env, constant));
+        };
+
+        template<typename E>
+        jobject ToJava(E value) const {
+            return Get(static_cast<jint>(value));
+        };
+
+        // Deletes the global references now. Otherwise this happens on destruction,
+        // if the destroying thread is attached to the VM. Not for bridges returned by ForClass.
+        void Release(JNIEnv *env);
+
+    private:
+        EnumBridge(const EnumBridge &);
+
+        EnumBridge &operator=(const EnumBridge &);
+
+        EnumBridge(JNIEnv *env, jclass clz, bool weak);
+
+        JavaVM *vm_;
+        jmethodID ordinal_;
+        bool weak_;
+        vector<jobject> constants_;
+        vector<string> names_;
+        unordered_map<string, jint> ordinals_;
+    };
+}
+
+#endif //NATIFLECT_ENUM_BRIDGE_H
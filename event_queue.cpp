@@ -0,0 +1,181 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "event_queue.h"
+
+#include <string.h>
+#include <new>
+#include <thread>
+
+#include "exception.h"
+
+namespace natiflect {
+
+    namespace {
+
+        jint JNICALL NativeOffer(JNIEnv *env, jclass, jlong queue, jobject records, jint count) {
+            EventQueue *event_queue = (EventQueue *) (intptr_t) queue;
+            char *address = records ? (char *) env->GetDirectBufferAddress(records) : NULL;
+            size_t record_size = event_queue ? event_queue->GetRecordSize() : 0;
+            if (!event_queue || !address || count < 0
+                || (jlong) count * (jlong) record_size > env->GetDirectBufferCapacity(records)) {
+                jclass exception_class = env->FindClass("java/lang/IllegalArgumentException");
+                if (exception_class) {
+                    env->ThrowNew(exception_class, "Expected a queue and a direct buffer holding count records.");
+                }
+                return 0;
+            }
+
+            return (jint) event_queue->Offer(address, (size_t) count);
+        }
+    }
+
+    EventQueue::EventQueue(size_t record_size, size_t capacity) {
+        if (record_size == 0 || capacity == 0) {
+            throw Exception("An event queue needs a record size and a capacity.");
+        }
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded <<= 1;
+        }
+        record_size_ = record_size;
+        // Keeps every sequence number aligned.
+        cell_size_ = (sizeof(atomic<size_t>) + record_size + alignof(atomic<size_t>) - 1)
+                     & ~(alignof(atomic<size_t>) - 1);
+        mask_ = rounded - 1;
+        cells_ = new char[cell_size_ * rounded];
+        for (size_t i = 0; i < rounded; i++) {
+            new(cells_ + i * cell_size_) atomic<size_t>(i);
+        }
+        enqueue_pos_.store(0, memory_order_relaxed);
+        dequeue_pos_.store(0, memory_order_relaxed);
+        dropped_.store(0, memory_order_relaxed);
+        closed_.store(false, memory_order_relaxed);
+        producers_.store(0, memory_order_relaxed);
+    }
+
+    EventQueue::~EventQueue() {
+        Close();
+        delete[] cells_;
+    }
+
+    void EventQueue::Close() {
+        closed_.store(true);
+        // A producer that got in before the flag was set is still copying.
+        while (producers_.load() != 0) {
+            this_thread::yield();
+        }
+    }
+
+    bool EventQueue::EnterProducer() {
+        // Both sequentially consistent, so that either Close() sees the producer or the producer sees
+        // the flag.
+        producers_.fetch_add(1);
+        if (closed_.load()) {
+            producers_.fetch_sub(1);
+            return false;
+        }
+        return true;
+    }
+
+    bool EventQueue::Offer(const void *record) {
+        if (!EnterProducer()) {
+            return false;
+        }
+        bool accepted = Push(record);
+        producers_.fetch_sub(1, memory_order_release);
+        return accepted;
+    }
+
+    bool EventQueue::Push(const void *record) {
+        size_t pos = enqueue_pos_.load(memory_order_relaxed);
+        for (;;) {
+            size_t sequence = GetSequence(pos).load(memory_order_acquire);
+            intptr_t diff = (intptr_t) sequence - (intptr_t) pos;
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                dropped_.fetch_add(1, memory_order_relaxed);
+                return false;
+            } else {
+                pos = enqueue_pos_.load(memory_order_relaxed);
+            }
+        }
+        memcpy(GetRecord(pos), record, record_size_);
+        GetSequence(pos).store(pos + 1, memory_order_release);
+        return true;
+    }
+
+    size_t EventQueue::Offer(const void *records, size_t count) {
+        if (!EnterProducer()) {
+            return 0;
+        }
+        const char *record = (const char *) records;
+        size_t accepted = 0;
+        for (; accepted < count; accepted++, record += record_size_) {
+            if (!Push(record)) {
+                // The refused record is already counted.
+                dropped_.fetch_add(count - accepted - 1, memory_order_relaxed);
+                break;
+            }
+        }
+        producers_.fetch_sub(1, memory_order_release);
+        return accepted;
+    }
+
+    size_t EventQueue::Poll(void *records, size_t max_records) {
+        size_t pos = dequeue_pos_.load(memory_order_relaxed);
+        size_t count = 0;
+        char *out = (char *) records;
+        while (count < max_records) {
+            atomic<size_t> &sequence = GetSequence(pos);
+            if (sequence.load(memory_order_acquire) != pos + 1) {
+                break;
+            }
+            memcpy(out + count * record_size_, GetRecord(pos), record_size_);
+            sequence.store(pos + mask_ + 1, memory_order_release);
+            pos++;
+            count++;
+        }
+        dequeue_pos_.store(pos, memory_order_relaxed);
+        return count;
+    }
+
+    size_t EventQueue::GetSize() const {
+        size_t enqueued = enqueue_pos_.load(memory_order_relaxed);
+        size_t dequeued = dequeue_pos_.load(memory_order_relaxed);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    void EventQueue::RegisterNatives(JNIEnv *env, jclass clz, const char *method_name) {
+        JNINativeMethod method;
+        method.name = const_cast<char *>(method_name);
+        method.signature = const_cast<char *>("(JLjava/nio/ByteBuffer;I)I");
+        method.fnPtr = (void *) NativeOffer;
+        if (env->RegisterNatives(clz, &method, 1) != JNI_OK) {
+            env->ExceptionClear();
+            throw NotFoundException(string("Cannot register native method \"") + method_name
+                                    + "\" with signature \"(JLjava/nio/ByteBuffer;I)I\".");
+        }
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_EVENT_QUEUE_H
+#define NATIFLECT_EVENT_QUEUE_H
+
+#include <jni.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+using namespace std;
+
+namespace natiflect {
+
+    // A bounded, lock-free queue of fixed-size records with many producers and a single consumer.
+    // Java threads produce through a static native method registered with RegisterNatives():
+    //
+    //     static native int offer(long queue, java.nio.ByteBuffer records, int count);
+    //
+    // which copies count records from the start of a direct buffer, usually one reused per thread,
+    // and returns how many were accepted before the queue was full. queue is GetHandle(). Producing
+    // creates no Java or JNI objects. Native code consumes with Poll().
+    //
+    // Java holds the queue as a raw pointer. To shut it down, call Close(), after which offers return 0,
+    // then make sure no Java code can call offer with the handle any more, e.g. by clearing the field
+    // that holds it, and only then destroy the queue.
+    class EventQueue {
+    public:
+        // capacity is rounded up to a power of two.
+        EventQueue(size_t record_size, size_t capacity);
+
+        ~EventQueue();
+
+        size_t GetRecordSize() const { return record_size_; };
+
+        size_t GetCapacity() const { return mask_ + 1; };
+
+        // Valid until the queue is destroyed; see above.
+        jlong GetHandle() { return (jlong) (intptr_t) this; };
+
+        // Returns false if the queue is full or closed. Safe from any thread.
+        bool Offer(const void *record);
+
+        // Offers count records stored back to back and returns how many were accepted before the
+        // queue was full. All the records refused count as dropped.
+        size_t Offer(const void *records, size_t count);
+
+        // Copies up to max_records records, oldest first, into records and returns how many.
+        // Only one thread may consume.
+        size_t Poll(void *records, size_t max_records);
+
+        size_t GetSize() const;
+
+        // Refuses all offers from now on, and waits for those in progress to finish. Records already
+        // queued can still be polled. Also done on destruction.
+        void Close();
+
+        bool IsClosed() const { return closed_.load(); };
+
+        // Records refused because the queue was full.
+        uint64_t GetDropped() const { return dropped_.load(memory_order_relaxed); };
+
+        // Registers the offer method on clz, which must declare it as above under method_name.
+        static void RegisterNatives(JNIEnv *env, jclass clz, const char *method_name = "offer");
+
+    private:
+        EventQueue(const EventQueue &);
+
+        EventQueue &operator=(const EventQueue &);
+
+        // Each cell is a sequence number followed by the record. A cell is free for position pos when
+        // its sequence is pos, and holds the record of pos when it is pos + 1.
+        atomic<size_t> &GetSequence(size_t pos) const {
+            return *(atomic<size_t> *) (cells_ + (pos & mask_) * cell_size_);
+        };
+
+        char *GetRecord(size_t pos) const {
+            return cells_ + (pos & mask_) * cell_size_ + sizeof(atomic<size_t>);
+        };
+
+        // Returns false if the queue is closed. Otherwise the caller must decrement producers_ when done.
+        bool EnterProducer();
+
+        bool Push(const void *record);
+
+        size_t record_size_;
+        size_t cell_size_;
+        size_t mask_;
+        char *cells_;
+
+        // Producers and the consumer write to separate cache lines.
+        char padding0_[64];
+        atomic<size_t> enqueue_pos_;
+        char padding1_[64];
+        atomic<size_t> dequeue_pos_;
+        char padding2_[64];
+        atomic<uint64_t> dropped_;
+        char padding3_[64];
+        atomic<bool> closed_;
+        // Producers between EnterProducer() and the end of their offer.
+        atomic<size_t> producers_;
+    };
+}
+
+#endif //NATIFLECT_EVENT_QUEUE_H
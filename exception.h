@@ -60,6 +60,21 @@ namespace natiflect {
 
         AccessException(string message) : Exception(message) { };
     };
+
+    struct CastException : Exception {
+    public:
+        CastException() { };
+
+        CastException(string message) : Exception(message) { };
+    };
+
+    // Thrown in checked mode, see checked.h.
+    struct ValidationException : Exception {
+    public:
+        ValidationException() { };
+
+        ValidationException(string message) : Exception(message) { };
+    };
 }
 
 #endif //NATIFLECT_EXCEPTION_H
@@ -0,0 +1,320 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "field_batch.h"
+
+#include "exception.h"
+#include "checked.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        // Number of objects of an array handled per local frame.
+        const jsize kFlushChunkSize = 256;
+    }
+
+    FieldBatch::FieldBatch(JNIEnv *env, jclass clz, bool is_static) {
+        env_ = env;
+        clz_ = clz;
+        is_static_ = is_static;
+    }
+
+#pragma mark - Queue
+
+    FieldBatch &FieldBatch::Queue(const char *name, const char *sig, uint64_t hash, char type, jvalue value) {
+        bool matches = type == 'L' ? (sig[0] == 'L' || sig[0] == '[') : (sig[0] == type && sig[1] == '\0');
+        if (!matches) {
+            throw AccessException(string("Field \"") + name + "\" with signature \"" + sig
+                                  + "\" cannot be written by Set_" + type + ".");
+        }
+
+        Write write;
+        write.field_id = GetFieldID(env_, clz_, MemberKey(name, sig, hash), is_static_);
+        write.type = type;
+        write.value = value;
+        write.name = name;
+        write.sig = sig;
+        writes_.push_back(write);
+        return *this;
+    }
+
+    FieldBatch &FieldBatch::Set_Z(const char *name, jboolean value) {
+        jvalue v;
+        v.z = value;
+        return Queue(name, "Z", HashMember(name, "Z"), 'Z', v);
+    }
+
+    FieldBatch &FieldBatch::Set_B(const char *name, jbyte value) {
+        jvalue v;
+        v.b = value;
+        return Queue(name, "B", HashMember(name, "B"), 'B', v);
+    }
+
+    FieldBatch &FieldBatch::Set_C(const char *name, jchar value) {
+        jvalue v;
+        v.c = value;
+        return Queue(name, "C", HashMember(name, "C"), 'C', v);
+    }
+
+    FieldBatch &FieldBatch::Set_S(const char *name, jshort value) {
+        jvalue v;
+        v.s = value;
+        return Queue(name, "S", HashMember(name, "S"), 'S', v);
+    }
+
+    FieldBatch &FieldBatch::Set_I(const char *name, jint value) {
+        jvalue v;
+        v.i = value;
+        return Queue(name, "I", HashMember(name, "I"), 'I', v);
+    }
+
+    FieldBatch &FieldBatch::Set_J(const char *name, jlong value) {
+        jvalue v;
+        v.j = value;
+        return Queue(name, "J", HashMember(name, "J"), 'J', v);
+    }
+
+    FieldBatch &FieldBatch::Set_F(const char *name, jfloat value) {
+        jvalue v;
+        v.f = value;
+        return Queue(name, "F", HashMember(name, "F"), 'F', v);
+    }
+
+    FieldBatch &FieldBatch::Set_D(const char *name, jdouble value) {
+        jvalue v;
+        v.d = value;
+        return Queue(name, "D", HashMember(name, "D"), 'D', v);
+    }
+
+    FieldBatch &FieldBatch::Set_L(const char *name, const char *sig, jobject value) {
+        jvalue v;
+        v.l = value;
+        return Queue(name, sig, HashMember(name, sig), 'L', v);
+    }
+
+    FieldBatch &FieldBatch::Set_Z(MemberKey key, jboolean value) {
+        jvalue v;
+        v.z = value;
+        return Queue(key.name, key.sig, key.hash, 'Z', v);
+    }
+
+    FieldBatch &FieldBatch::Set_B(MemberKey key, jbyte value) {
+        jvalue v;
+        v.b = value;
+        return Queue(key.name, key.sig, key.hash, 'B', v);
+    }
+
+    FieldBatch &FieldBatch::Set_C(MemberKey key, jchar value) {
+        jvalue v;
+        v.c = value;
+        return Queue(key.name, key.sig, key.hash, 'C', v);
+    }
+
+    FieldBatch &FieldBatch::Set_S(MemberKey key, jshort value) {
+        jvalue v;
+        v.s = value;
+        return Queue(key.name, key.sig, key.hash, 'S', v);
+    }
+
+    FieldBatch &FieldBatch::Set_I(MemberKey key, jint value) {
+        jvalue v;
+        v.i = value;
+        return Queue(key.name, key.sig, key.hash, 'I', v);
+    }
+
+    FieldBatch &FieldBatch::Set_J(MemberKey key, jlong value) {
+        jvalue v;
+        v.j = value;
+        return Queue(key.name, key.sig, key.hash, 'J', v);
+    }
+
+    FieldBatch &FieldBatch::Set_F(MemberKey key, jfloat value) {
+        jvalue v;
+        v.f = value;
+        return Queue(key.name, key.sig, key.hash, 'F', v);
+    }
+
+    FieldBatch &FieldBatch::Set_D(MemberKey key, jdouble value) {
+        jvalue v;
+        v.d = value;
+        return Queue(key.name, key.sig, key.hash, 'D', v);
+    }
+
+    FieldBatch &FieldBatch::Set_L(MemberKey key, jobject value) {
+        jvalue v;
+        v.l = value;
+        return Queue(key.name, key.sig, key.hash, 'L', v);
+    }
+
+#pragma mark - Flush
+
+    void FieldBatch::Apply(jobject obj) {
+        for (vector<Write>::const_iterator it = writes_.begin(); it != writes_.end(); ++it) {
+            NF_CHECK_FIELD(env_, is_static_ ? clz_ : obj, it->name.c_str(), it->sig.c_str(), it->type);
+            if (is_static_) {
+                switch (it->type) {
+                    case 'Z':
+                        env_->SetStaticBooleanField(clz_, it->field_id, it->value.z);
+                        break;
+                    case 'B':
+                        env_->SetStaticByteField(clz_, it->field_id, it->value.b);
+                        break;
+                    case 'C':
+                        env_->SetStaticCharField(clz_, it->field_id, it->value.c);
+                        break;
+                    case 'S':
+                        env_->SetStaticShortField(clz_, it->field_id, it->value.s);
+                        break;
+                    case 'I':
+                        env_->SetStaticIntField(clz_, it->field_id, it->value.i);
+                        break;
+                    case 'J':
+                        env_->SetStaticLongField(clz_, it->field_id, it->value.j);
+                        break;
+                    case 'F':
+                        env_->SetStaticFloatField(clz_, it->field_id, it->value.f);
+                        break;
+                    case 'D':
+                        env_->SetStaticDoubleField(clz_, it->field_id, it->value.d);
+                        break;
+                    default:
+                        env_->SetStaticObjectField(clz_, it->field_id, it->value.l);
+                        break;
+                }
+                continue;
+            }
+            switch (it->type) {
+                case 'Z':
+                    env_->SetBooleanField(obj, it->field_id, it->value.z);
+                    break;
+                case 'B':
+                    env_->SetByteField(obj, it->field_id, it->value.b);
+                    break;
+                case 'C':
+                    env_->SetCharField(obj, it->field_id, it->value.c);
+                    break;
+                case 'S':
+                    env_->SetShortField(obj, it->field_id, it->value.s);
+                    break;
+                case 'I':
+                    env_->SetIntField(obj, it->field_id, it->value.i);
+                    break;
+                case 'J':
+                    env_->SetLongField(obj, it->field_id, it->value.j);
+                    break;
+                case 'F':
+                    env_->SetFloatField(obj, it->field_id, it->value.f);
+                    break;
+                case 'D':
+                    env_->SetDoubleField(obj, it->field_id, it->value.d);
+                    break;
+                default:
+                    env_->SetObjectField(obj, it->field_id, it->value.l);
+                    break;
+            }
+        }
+    }
+
+    void FieldBatch::CheckInstance(jobject obj) {
+        if (!env_->IsInstanceOf(obj, clz_)) {
+            throw AccessException("Cannot write fields of an object of another class.");
+        }
+    }
+
+    void FieldBatch::CheckFlush(size_t objects) {
+        if (!env_->ExceptionCheck()) {
+            return;
+        }
+        env_->ExceptionClear();
+        string names;
+        for (vector<Write>::const_iterator it = writes_.begin(); it != writes_.end(); ++it) {
+            names += (names.empty() ? "\"" : ", \"") + it->name + "\"";
+        }
+        throw AccessException("Write" + string(is_static_ ? " static " : " ") + "fields " + names + " of "
+                              + to_string(objects) + (objects == 1 ? " object" : " objects") + " failed.");
+    }
+
+    void FieldBatch::Flush() {
+        if (!is_static_) {
+            throw AccessException("Flush instance fields with the objects to write to.");
+        }
+        Apply(NULL);
+        CheckFlush(1);
+    }
+
+    void FieldBatch::Flush(jobject obj) {
+        if (is_static_) {
+            Flush();
+            return;
+        }
+        if (!obj) {
+            throw AccessException("Cannot write fields of a null object.");
+        }
+        CheckInstance(obj);
+        Apply(obj);
+        CheckFlush(1);
+    }
+
+    void FieldBatch::Flush(const vector<jobject> &objects) {
+        // Checked up front, so that nothing is written when any object is of another class.
+        for (vector<jobject>::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+            if (*it) {
+                CheckInstance(*it);
+            }
+        }
+        for (vector<jobject>::const_iterator it = objects.begin(); it != objects.end(); ++it) {
+            if (*it) {
+                Apply(*it);
+            }
+        }
+        CheckFlush(objects.size());
+    }
+
+    void FieldBatch::Flush(jobjectArray objects) {
+        jsize length = env_->GetArrayLength(objects);
+        // Checked up front, so that nothing is written when any object is of another class.
+        for (jsize chunk = 0; chunk < length; chunk += kFlushChunkSize) {
+            LocalFrame frame(env_, kFlushChunkSize);
+            jsize chunk_end = chunk + kFlushChunkSize < length ? chunk + kFlushChunkSize : length;
+            for (jsize i = chunk; i < chunk_end; i++) {
+                jobject obj = env_->GetObjectArrayElement(objects, i);
+                if (obj) {
+                    CheckInstance(obj);
+                    env_->DeleteLocalRef(obj);
+                }
+            }
+        }
+        for (jsize chunk = 0; chunk < length; chunk += kFlushChunkSize) {
+            LocalFrame frame(env_, kFlushChunkSize);
+            jsize chunk_end = chunk + kFlushChunkSize < length ? chunk + kFlushChunkSize : length;
+            for (jsize i = chunk; i < chunk_end; i++) {
+                jobject obj = env_->GetObjectArrayElement(objects, i);
+                if (obj) {
+                    Apply(obj);
+                    env_->DeleteLocalRef(obj);
+                }
+            }
+        }
+        CheckFlush((size_t) length);
+    }
+}
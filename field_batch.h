@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_FIELD_BATCH_H
+#define NATIFLECT_FIELD_BATCH_H
+
+#include <jni.h>
+#include <string>
+#include <vector>
+
+#include "member_key.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // Queues writes to the fields of one class, with their field IDs resolved when queued, and applies
+    // them all at once to one or many objects, checking for an exception once per flush. The queue is
+    // kept after a flush, so the same values can be written to more objects; Clear() empties it.
+    class FieldBatch {
+    public:
+        // With is_static, the writes go to static fields of clz and are applied with Flush().
+        FieldBatch(JNIEnv *env, jclass clz, bool is_static = false);
+
+        FieldBatch &Set_Z(const char *name, jboolean value);
+
+        FieldBatch &Set_B(const char *name, jbyte value);
+
+        FieldBatch &Set_C(const char *name, jchar value);
+
+        FieldBatch &Set_S(const char *name, jshort value);
+
+        FieldBatch &Set_I(const char *name, jint value);
+
+        FieldBatch &Set_J(const char *name, jlong value);
+
+        FieldBatch &Set_F(const char *name, jfloat value);
+
+        FieldBatch &Set_D(const char *name, jdouble value);
+
+        FieldBatch &Set_L(const char *name, const char *sig, jobject value);
+
+        // The signature comes from the key and must match the setter, or AccessException is thrown.
+        FieldBatch &Set_Z(MemberKey key, jboolean value);
+
+        FieldBatch &Set_B(MemberKey key, jbyte value);
+
+        FieldBatch &Set_C(MemberKey key, jchar value);
+
+        FieldBatch &Set_S(MemberKey key, jshort value);
+
+        FieldBatch &Set_I(MemberKey key, jint value);
+
+        FieldBatch &Set_J(MemberKey key, jlong value);
+
+        FieldBatch &Set_F(MemberKey key, jfloat value);
+
+        FieldBatch &Set_D(MemberKey key, jdouble value);
+
+        FieldBatch &Set_L(MemberKey key, jobject value);
+
+        size_t GetSize() const { return writes_.size(); };
+
+        void Clear() { writes_.clear(); };
+
+        // Applies the writes to static fields.
+        void Flush();
+
+        void Flush(jobject obj);
+
+        // Applies the writes to every object. Null objects are skipped, and if any object is not an instance
+        // of the class, AccessException is thrown before anything is written.
+        void Flush(const vector<jobject> &objects);
+
+        void Flush(jobjectArray objects);
+
+    private:
+        struct Write {
+            jfieldID field_id;
+            char type;
+            jvalue value;
+            string name;
+            string sig;
+        };
+
+        FieldBatch &Queue(const char *name, const char *sig, uint64_t hash, char type, jvalue value);
+
+        void Apply(jobject obj);
+
+        // Field IDs of the class must never be used on objects of another class, which JNI does not check.
+        void CheckInstance(jobject obj);
+
+        void CheckFlush(size_t objects);
+
+        JNIEnv *env_;
+        jclass clz_;
+        bool is_static_;
+        vector<Write> writes_;
+    };
+}
+
+#endif //NATIFLECT_FIELD_BATCH_H
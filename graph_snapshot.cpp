@@ -0,0 +1,524 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "graph_snapshot.h"
+
+#include <algorithm>
+
+#include "exception.h"
+#include "array_traits.h"
+#include "class_index.h"
+#include "collections.h"
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const size_t kMinVisitedCapacity = 64;
+
+        // Visited objects are held as local references, in frames pushed for this many objects at a time.
+        const jint kVisitedFrameSize = 1024;
+
+        template<typename E>
+        const void *CopyElements(JNIEnv *env, Arena &arena, jobject array, jsize length) {
+            E *elements = arena.Allocate<E>((size_t) length);
+            if (length > 0) {
+                ArrayTraits<E>::GetRegion(env, (typename ArrayTraits<E>::ArrayType) array, 0, length, elements);
+            }
+            return elements;
+        }
+
+        void ReadField(JNIEnv *env, jobject obj, const SnapshotField &field, SnapshotValue *out) {
+            out->type = field.sig[0];
+            switch (out->type) {
+                case 'Z':
+                    out->z = env->GetBooleanField(obj, field.id);
+                    break;
+                case 'B':
+                    out->b = env->GetByteField(obj, field.id);
+                    break;
+                case 'C':
+                    out->c = env->GetCharField(obj, field.id);
+                    break;
+                case 'S':
+                    out->s = env->GetShortField(obj, field.id);
+                    break;
+                case 'I':
+                    out->i = env->GetIntField(obj, field.id);
+                    break;
+                case 'J':
+                    out->j = env->GetLongField(obj, field.id);
+                    break;
+                case 'F':
+                    out->f = env->GetFloatField(obj, field.id);
+                    break;
+                case 'D':
+                    out->d = env->GetDoubleField(obj, field.id);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+#pragma mark - Arena
+
+    Arena::Arena(size_t block_size) {
+        block_size_ = block_size;
+        current_ = 0;
+        offset_ = 0;
+        used_before_current_ = 0;
+    }
+
+    Arena::~Arena() {
+        for (size_t i = 0; i < blocks_.size(); i++) {
+            delete[] blocks_[i].data;
+        }
+    }
+
+    void *Arena::Allocate(size_t size, size_t alignment) {
+        while (current_ < blocks_.size()) {
+            Block &block = blocks_[current_];
+            size_t start = (offset_ + alignment - 1) & ~(alignment - 1);
+            if (start + size <= block.size) {
+                offset_ = start + size;
+                return block.data + start;
+            }
+            used_before_current_ += offset_;
+            current_++;
+            offset_ = 0;
+        }
+
+        // Blocks come from new[], which aligns them for any fundamental type.
+        Block block;
+        block.size = max(block_size_, size);
+        block.data = new char[block.size];
+        blocks_.push_back(block);
+        current_ = blocks_.size() - 1;
+        offset_ = size;
+        return block.data;
+    }
+
+    void Arena::Reset() {
+        current_ = 0;
+        offset_ = 0;
+        used_before_current_ = 0;
+    }
+
+    size_t Arena::GetUsedBytes() const {
+        return used_before_current_ + offset_;
+    }
+
+    size_t Arena::GetReservedBytes() const {
+        size_t bytes = 0;
+        for (size_t i = 0; i < blocks_.size(); i++) {
+            bytes += blocks_[i].size;
+        }
+        return bytes;
+    }
+
+#pragma mark - GraphSnapshot
+
+    GraphSnapshot::GraphSnapshot(JNIEnv *env, const SnapshotOptions &options) : options_(options) {
+        env_ = env;
+        env_->GetJavaVM(&vm_);
+        root_.type = 'N';
+        visited_count_ = 0;
+        object_count_ = 0;
+        visited_frames_ = 0;
+        for (size_t i = 0; i < kRecentLayouts; i++) {
+            recent_layouts_[i] = NULL;
+        }
+
+        system_class_ = NULL;
+        string_class_ = NULL;
+        collection_class_ = NULL;
+        map_class_ = NULL;
+        LocalFrame frame(env_, 8);
+        const char *names[] = {"java/lang/System", "java/lang/String", "java/util/Collection", "java/util/Map"};
+        jclass *targets[] = {&system_class_, &string_class_, &collection_class_, &map_class_};
+        try {
+            for (int i = 0; i < 4; i++) {
+                jclass clz = env_->FindClass(names[i]);
+                CheckNotFoundException(env_, string("class \"") + names[i] + "\"");
+                *targets[i] = (jclass) env_->NewGlobalRef(clz);
+                RefMonitor::OnCreate(kGlobalRef, *targets[i], "GraphSnapshot");
+            }
+            identity_hash_code_ = GetMethodID(env_, system_class_, "identityHashCode", "(Ljava/lang/Object;)I",
+                                              true);
+        } catch (...) {
+            DeleteClasses(env_);
+            throw;
+        }
+    }
+
+    GraphSnapshot::~GraphSnapshot() {
+        JNIEnv *env = GetAttachedEnv(vm_);
+        if (!env) {
+            return;
+        }
+        for (LayoutMap::iterator it = layouts_.begin(); it != layouts_.end(); ++it) {
+            DeleteLayout(env, it->second);
+        }
+        DeleteStaleLayouts(env);
+        DeleteClasses(env);
+    }
+
+    void GraphSnapshot::DeleteClasses(JNIEnv *env) {
+        jclass *targets[] = {&system_class_, &string_class_, &collection_class_, &map_class_};
+        for (int i = 0; i < 4; i++) {
+            if (*targets[i]) {
+                RefMonitor::OnDelete(kGlobalRef, *targets[i], "GraphSnapshot");
+                env->DeleteGlobalRef(*targets[i]);
+                *targets[i] = NULL;
+            }
+        }
+    }
+
+    const SnapshotValue &GraphSnapshot::Take(jobject root) {
+        arena_.Reset();
+        // Nothing points to them any more.
+        DeleteStaleLayouts(env_);
+        root_.type = 'N';
+        object_count_ = 0;
+        int64_t saved_local_refs = RefMonitor::EnterFrame();
+        try {
+            Walk(root, 0, &root_);
+        } catch (...) {
+            ClearVisited();
+            RefMonitor::LeaveFrame(saved_local_refs);
+            throw;
+        }
+        object_count_ = visited_count_;
+        ClearVisited();
+        RefMonitor::LeaveFrame(saved_local_refs);
+        return root_;
+    }
+
+    jint GraphSnapshot::IdentityHash(jobject obj) {
+        jint hash = env_->CallStaticIntMethod(system_class_, identity_hash_code_, obj);
+        CheckCallMethodException(env_, "identityHashCode", "(Ljava/lang/Object;)I", true);
+        return hash;
+    }
+
+    const SnapshotLayout *GraphSnapshot::GetLayout(jclass clz) {
+        // Objects of a graph are mostly of a few classes, which are found here without an upcall.
+        for (size_t i = 0; i < kRecentLayouts && recent_layouts_[i]; i++) {
+            if (env_->IsSameObject(recent_layouts_[i]->clz, clz)) {
+                return recent_layouts_[i];
+            }
+        }
+        const SnapshotLayout *layout = FindLayout(clz);
+        for (size_t i = kRecentLayouts - 1; i > 0; i--) {
+            recent_layouts_[i] = recent_layouts_[i - 1];
+        }
+        recent_layouts_[0] = layout;
+        return layout;
+    }
+
+    const SnapshotLayout *GraphSnapshot::FindLayout(jclass clz) {
+        jint hash = IdentityHash(clz);
+        pair<LayoutMap::iterator, LayoutMap::iterator> range = layouts_.equal_range(hash);
+        for (LayoutMap::iterator it = range.first; it != range.second;) {
+            if (env_->IsSameObject(it->second->clz, clz)) {
+                return it->second;
+            }
+            if (env_->IsSameObject(it->second->clz, NULL)) {
+                // The class was unloaded. Values taken earlier in this snapshot may still point to the
+                // layout, so it is only deleted by the next Take.
+                stale_layouts_.push_back(it->second);
+                it = layouts_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        // Allocated only once resolving it can no longer throw.
+        SnapshotLayout resolved;
+        resolved.class_name = GetClassName(env_, clz);
+        resolved.element_type = 0;
+        if (env_->IsSameObject(clz, string_class_)) {
+            resolved.kind = 'T';
+        } else if (resolved.class_name[0] == '[') {
+            resolved.kind = 'A';
+            char element = resolved.class_name[1];
+            resolved.element_type = element == '[' || element == 'L' ? 'L' : element;
+        } else if (env_->IsAssignableFrom(clz, map_class_)) {
+            resolved.kind = 'M';
+        } else if (env_->IsAssignableFrom(clz, collection_class_)) {
+            resolved.kind = 'C';
+        } else {
+            resolved.kind = 'O';
+            ClassIndex index(env_, clz);
+            const vector<ClassIndex::Field> &fields = index.GetFields();
+            for (size_t i = 0; i < fields.size(); i++) {
+                if (fields[i].is_static) {
+                    continue;
+                }
+                SnapshotField field;
+                field.name = fields[i].name;
+                field.sig = fields[i].sig;
+                field.id = fields[i].id;
+                resolved.fields.push_back(field);
+            }
+        }
+        SnapshotLayout *layout = new SnapshotLayout;
+        layout->class_name.swap(resolved.class_name);
+        layout->kind = resolved.kind;
+        layout->element_type = resolved.element_type;
+        layout->fields.swap(resolved.fields);
+        layout->clz = env_->NewWeakGlobalRef(clz);
+        RefMonitor::OnCreate(kWeakGlobalRef, layout->clz, "GraphSnapshot");
+        layouts_.insert(make_pair(hash, layout));
+        return layout;
+    }
+
+    void GraphSnapshot::DeleteLayout(JNIEnv *env, SnapshotLayout *layout) {
+        RefMonitor::OnDelete(kWeakGlobalRef, layout->clz, "GraphSnapshot");
+        env->DeleteWeakGlobalRef(layout->clz);
+        delete layout;
+    }
+
+    void GraphSnapshot::DeleteStaleLayouts(JNIEnv *env) {
+        if (stale_layouts_.empty()) {
+            return;
+        }
+        for (size_t i = 0; i < kRecentLayouts; i++) {
+            recent_layouts_[i] = NULL;
+        }
+        for (size_t i = 0; i < stale_layouts_.size(); i++) {
+            DeleteLayout(env, stale_layouts_[i]);
+        }
+        stale_layouts_.clear();
+    }
+
+#pragma mark - Visited Objects
+
+    const SnapshotValue *GraphSnapshot::FindVisited(jobject obj, jint hash) {
+        if (visited_.empty()) {
+            return NULL;
+        }
+        size_t mask = visited_.size() - 1;
+        for (size_t i = (size_t) hash & mask; visited_[i].ref; i = (i + 1) & mask) {
+            if (visited_[i].hash == hash && env_->IsSameObject(visited_[i].ref, obj)) {
+                return &visited_[i].value;
+            }
+        }
+        return NULL;
+    }
+
+    void GraphSnapshot::AddVisited(jobject obj, jint hash, const SnapshotValue &value) {
+        if ((visited_count_ + 1) * 2 > visited_.size()) {
+            vector<Visited> old;
+            old.swap(visited_);
+            Visited empty;
+            empty.ref = NULL;
+            visited_.assign(max(kMinVisitedCapacity, old.size() * 2), empty);
+            size_t mask = visited_.size() - 1;
+            for (size_t i = 0; i < old.size(); i++) {
+                if (old[i].ref) {
+                    size_t j = (size_t) old[i].hash & mask;
+                    while (visited_[j].ref) {
+                        j = (j + 1) & mask;
+                    }
+                    visited_[j] = old[i];
+                }
+            }
+        }
+
+        size_t mask = visited_.size() - 1;
+        size_t i = (size_t) hash & mask;
+        while (visited_[i].ref) {
+            i = (i + 1) & mask;
+        }
+        if (visited_count_ % kVisitedFrameSize == 0) {
+            if (env_->PushLocalFrame(kVisitedFrameSize) < 0) {
+                env_->ExceptionClear();
+                throw Exception("Cannot push a local frame for the visited objects.");
+            }
+            visited_frames_++;
+        }
+        visited_[i].hash = hash;
+        visited_[i].ref = env_->NewLocalRef(obj);
+        RefMonitor::OnCreate(kLocalRef, visited_[i].ref, "GraphSnapshot");
+        visited_[i].value = value;
+        visited_count_++;
+    }
+
+    void GraphSnapshot::ClearVisited() {
+        // Releases the visited objects all at once. Frames pushed in between by the walk are balanced.
+        for (; visited_frames_ > 0; visited_frames_--) {
+            env_->PopLocalFrame(NULL);
+        }
+        for (size_t i = 0; i < visited_.size(); i++) {
+            visited_[i].ref = NULL;
+        }
+        visited_count_ = 0;
+    }
+
+#pragma mark - Walking
+
+    void GraphSnapshot::Walk(jobject obj, size_t depth, SnapshotValue *out) {
+        if (!obj) {
+            out->type = 'N';
+            return;
+        }
+        if (depth > options_.max_depth) {
+            out->type = 'X';
+            return;
+        }
+
+        jclass clz = env_->GetObjectClass(obj);
+        const SnapshotLayout *layout = GetLayout(clz);
+        env_->DeleteLocalRef(clz);
+        if (layout->kind == 'T') {
+            CopyString((jstring) obj, out);
+            return;
+        }
+
+        jint hash = IdentityHash(obj);
+        const SnapshotValue *visited = FindVisited(obj, hash);
+        if (visited) {
+            *out = *visited;
+            return;
+        }
+
+        if (layout->kind == 'O') {
+            WalkObject(obj, hash, layout, depth, out);
+            return;
+        }
+
+        // Registered before walking the elements, so that a cycle back to it finds it.
+        SnapshotArray *array = arena_.Allocate<SnapshotArray>(1);
+        array->length = 0;
+        array->elements = NULL;
+        out->type = layout->kind == 'M' ? 'M' : 'A';
+        out->array = array;
+        AddVisited(obj, hash, *out);
+
+        if (layout->kind == 'A') {
+            WalkArray(obj, layout->element_type, depth, array);
+        } else if (layout->kind == 'C') {
+            jobjectArray elements = CollectionToArray(env_, obj);
+            WalkArray(elements, 'L', depth, array);
+            env_->DeleteLocalRef(elements);
+        } else {
+            WalkMap(obj, depth, array);
+        }
+    }
+
+    void GraphSnapshot::WalkObject(jobject obj, jint hash, const SnapshotLayout *layout, size_t depth,
+                                   SnapshotValue *out) {
+        SnapshotObject *object = arena_.Allocate<SnapshotObject>(1);
+        SnapshotValue *fields = arena_.Allocate<SnapshotValue>(layout->fields.size());
+        object->layout = layout;
+        object->fields = fields;
+        out->type = 'O';
+        out->object = object;
+        AddVisited(obj, hash, *out);
+
+        for (size_t i = 0; i < layout->fields.size(); i++) {
+            const SnapshotField &field = layout->fields[i];
+            char type = field.sig[0];
+            if (type != 'L' && type != '[') {
+                ReadField(env_, obj, field, &fields[i]);
+                continue;
+            }
+            jobject value = env_->GetObjectField(obj, field.id);
+            Walk(value, depth + 1, &fields[i]);
+            env_->DeleteLocalRef(value);
+        }
+    }
+
+    void GraphSnapshot::WalkArray(jobject array, char element_type, size_t depth, SnapshotArray *out) {
+        jsize length = env_->GetArrayLength((jarray) array);
+        out->element_type = element_type;
+        out->length = (size_t) length;
+        switch (element_type) {
+            case 'Z':
+                out->elements = CopyElements<jboolean>(env_, arena_, array, length);
+                return;
+            case 'B':
+                out->elements = CopyElements<jbyte>(env_, arena_, array, length);
+                return;
+            case 'C':
+                out->elements = CopyElements<jchar>(env_, arena_, array, length);
+                return;
+            case 'S':
+                out->elements = CopyElements<jshort>(env_, arena_, array, length);
+                return;
+            case 'I':
+                out->elements = CopyElements<jint>(env_, arena_, array, length);
+                return;
+            case 'J':
+                out->elements = CopyElements<jlong>(env_, arena_, array, length);
+                return;
+            case 'F':
+                out->elements = CopyElements<jfloat>(env_, arena_, array, length);
+                return;
+            case 'D':
+                out->elements = CopyElements<jdouble>(env_, arena_, array, length);
+                return;
+            default:
+                break;
+        }
+
+        SnapshotValue *elements = arena_.Allocate<SnapshotValue>((size_t) length);
+        out->elements = elements;
+        for (jsize i = 0; i < length; i++) {
+            jobject element = env_->GetObjectArrayElement((jobjectArray) array, i);
+            Walk(element, depth + 1, &elements[i]);
+            env_->DeleteLocalRef(element);
+        }
+    }
+
+    void GraphSnapshot::WalkMap(jobject map, size_t depth, SnapshotArray *out) {
+        jobjectArray entries = MapToEntryArray(env_, map);
+        jsize length = env_->GetArrayLength(entries);
+        SnapshotValue *elements = arena_.Allocate<SnapshotValue>((size_t) length * 2);
+        out->element_type = 'L';
+        out->length = (size_t) length * 2;
+        out->elements = elements;
+        for (jsize i = 0; i < length; i++) {
+            jobject entry = env_->GetObjectArrayElement(entries, i);
+            jobject key = GetEntryKey(env_, entry);
+            Walk(key, depth + 1, &elements[i * 2]);
+            env_->DeleteLocalRef(key);
+            jobject value = GetEntryValue(env_, entry);
+            Walk(value, depth + 1, &elements[i * 2 + 1]);
+            env_->DeleteLocalRef(value);
+            env_->DeleteLocalRef(entry);
+        }
+        env_->DeleteLocalRef(entries);
+    }
+
+    void GraphSnapshot::CopyString(jstring str, SnapshotValue *out) {
+        jsize length = env_->GetStringUTFLength(str);
+        char *chars = arena_.Allocate<char>((size_t) length + 1);
+        env_->GetStringUTFRegion(str, 0, env_->GetStringLength(str), chars);
+        chars[length] = '\0';
+        out->type = 'T';
+        out->text.chars = chars;
+        out->text.length = (size_t) length;
+    }
+}
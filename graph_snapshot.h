@@ -0,0 +1,232 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_GRAPH_SNAPSHOT_H
+#define NATIFLECT_GRAPH_SNAPSHOT_H
+
+#include <jni.h>
+#include <stddef.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace std;
+
+namespace natiflect {
+
+    // A bump allocator over blocks that are kept when it is reset, so refilling it allocates nothing.
+    class Arena {
+    public:
+        explicit Arena(size_t block_size = 64 << 10);
+
+        ~Arena();
+
+        void *Allocate(size_t size, size_t alignment = sizeof(void *));
+
+        template<typename T>
+        T *Allocate(size_t count) {
+            return (T *) Allocate(sizeof(T) * count, alignof(T));
+        };
+
+        // Frees nothing; everything allocated so far becomes invalid.
+        void Reset();
+
+        size_t GetUsedBytes() const;
+
+        size_t GetReservedBytes() const;
+
+    private:
+        Arena(const Arena &);
+
+        Arena &operator=(const Arena &);
+
+        struct Block {
+            char *data;
+            size_t size;
+        };
+
+        size_t block_size_;
+        vector<Block> blocks_;
+        size_t current_;
+        size_t offset_;
+        size_t used_before_current_;
+    };
+
+    struct SnapshotField {
+        string name;
+        string sig;
+        jfieldID id;
+    };
+
+    // How objects of one class are walked, resolved once per class.
+    struct SnapshotLayout {
+        string class_name;
+        // 'O' for plain objects, 'T' for strings, 'A' for arrays, 'C' for collections and 'M' for maps.
+        char kind;
+        // Signature character of the elements of an array, 'L' for objects.
+        char element_type;
+        // Instance fields of plain objects, including inherited ones.
+        vector<SnapshotField> fields;
+        jweak clz;
+    };
+
+    struct SnapshotObject;
+    struct SnapshotArray;
+
+    struct SnapshotText {
+        // Modified UTF-8, null-terminated.
+        const char *chars;
+        size_t length;
+    };
+
+    struct SnapshotValue {
+        // The signature character of a primitive, 'T' for strings, 'O' for objects, 'A' for arrays and
+        // collections, 'M' for maps, 'N' for null and 'X' for objects beyond the depth limit.
+        char type;
+        union {
+            jboolean z;
+            jbyte b;
+            jchar c;
+            jshort s;
+            jint i;
+            jlong j;
+            jfloat f;
+            jdouble d;
+            SnapshotText text;
+            const SnapshotObject *object;
+            const SnapshotArray *array;
+        };
+    };
+
+    struct SnapshotObject {
+        const SnapshotLayout *layout;
+        // One value per field of the layout.
+        const SnapshotValue *fields;
+    };
+
+    struct SnapshotArray {
+        // Signature character of the elements, 'L' for objects; collections are 'L' and maps hold their
+        // keys and values interleaved.
+        char element_type;
+        size_t length;
+        // An array of the primitive type, or of SnapshotValue for 'L'.
+        const void *elements;
+    };
+
+    struct SnapshotOptions {
+        SnapshotOptions() : max_depth(64) { };
+
+        // References deeper than this are recorded as 'X' instead of being followed.
+        size_t max_depth;
+    };
+
+    // Copies an object graph into native memory: primitives, strings, arrays, collections, maps and the
+    // instance fields of other objects, walked through field layouts cached per class. An object reached
+    // twice, including through a cycle, is copied once and shared, so the copy keeps the shape of the
+    // graph. The copy lives in an arena reused by the next snapshot, and objects seen are held as local
+    // references released when the walk is done, so once warmed up, taking snapshots of similar graphs
+    // allocates nothing. Each object other than a string costs one identityHashCode upcall; layouts of
+    // the last few classes seen are found without one. Not thread-safe; use one per thread.
+    class GraphSnapshot {
+    public:
+        GraphSnapshot(JNIEnv *env, const SnapshotOptions &options = SnapshotOptions());
+
+        ~GraphSnapshot();
+
+        // The returned value, and everything it points to, is valid until the next Take.
+        const SnapshotValue &Take(jobject root);
+
+        // Objects copied by the last Take, strings excluded.
+        size_t GetObjectCount() const { return object_count_; };
+
+        const Arena &GetArena() const { return arena_; };
+
+    private:
+        GraphSnapshot(const GraphSnapshot &);
+
+        GraphSnapshot &operator=(const GraphSnapshot &);
+
+        struct Visited {
+            jint hash;
+            // A local reference, valid during Take only.
+            jobject ref;
+            SnapshotValue value;
+        };
+
+        static const size_t kRecentLayouts = 4;
+
+        const SnapshotLayout *GetLayout(jclass clz);
+
+        const SnapshotLayout *FindLayout(jclass clz);
+
+        void DeleteLayout(JNIEnv *env, SnapshotLayout *layout);
+
+        void DeleteStaleLayouts(JNIEnv *env);
+
+        void DeleteClasses(JNIEnv *env);
+
+        jint IdentityHash(jobject obj);
+
+        const SnapshotValue *FindVisited(jobject obj, jint hash);
+
+        void AddVisited(jobject obj, jint hash, const SnapshotValue &value);
+
+        void ClearVisited();
+
+        void Walk(jobject obj, size_t depth, SnapshotValue *out);
+
+        void WalkObject(jobject obj, jint hash, const SnapshotLayout *layout, size_t depth, SnapshotValue *out);
+
+        void WalkArray(jobject array, char element_type, size_t depth, SnapshotArray *out);
+
+        void WalkMap(jobject map, size_t depth, SnapshotArray *out);
+
+        void CopyString(jstring str, SnapshotValue *out);
+
+        JNIEnv *env_;
+        JavaVM *vm_;
+        SnapshotOptions options_;
+        Arena arena_;
+        SnapshotValue root_;
+
+        jclass system_class_;
+        jmethodID identity_hash_code_;
+        jclass string_class_;
+        jclass collection_class_;
+        jclass map_class_;
+
+        typedef unordered_multimap<jint, SnapshotLayout *> LayoutMap;
+
+        // Keyed by the identity hash code of the class.
+        LayoutMap layouts_;
+        // Layouts of unloaded classes, deleted by the next Take.
+        vector<SnapshotLayout *> stale_layouts_;
+        // Open addressing over identity hash codes, with a power-of-two size.
+        vector<Visited> visited_;
+        size_t visited_count_;
+        size_t visited_frames_;
+        size_t object_count_;
+        // Most recently used first.
+        const SnapshotLayout *recent_layouts_[kRecentLayouts];
+    };
+}
+
+#endif //NATIFLECT_GRAPH_SNAPSHOT_H
@@ -0,0 +1,187 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "instance_builder.h"
+
+#include "collections.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const jsize kChunkSize = 256;
+
+        jvalue GetValue(const Column &column, jsize index) {
+            jvalue value;
+            switch (column.type) {
+                case 'Z':
+                    value.z = ((const jboolean *) column.values)[index];
+                    break;
+                case 'B':
+                    value.b = ((const jbyte *) column.values)[index];
+                    break;
+                case 'C':
+                    value.c = ((const jchar *) column.values)[index];
+                    break;
+                case 'S':
+                    value.s = ((const jshort *) column.values)[index];
+                    break;
+                case 'I':
+                    value.i = ((const jint *) column.values)[index];
+                    break;
+                case 'J':
+                    value.j = ((const jlong *) column.values)[index];
+                    break;
+                case 'F':
+                    value.f = ((const jfloat *) column.values)[index];
+                    break;
+                case 'D':
+                    value.d = ((const jdouble *) column.values)[index];
+                    break;
+                default:
+                    value.l = ((const jobject *) column.values)[index];
+                    break;
+            }
+            return value;
+        }
+
+        char GetTypeChar(const char *sig) {
+            return sig[0] == '[' ? 'L' : sig[0];
+        }
+    }
+
+#pragma mark - Public
+
+    InstanceBuilder::InstanceBuilder(JNIEnv *env, jclass clz, const char *constructor_sig,
+                                     const vector<Column> &columns) : sig_(constructor_sig), columns_(columns) {
+        env_ = env;
+        clz_ = clz;
+        string param_types;
+        char return_type;
+        if (!ParseMethodSignature(constructor_sig, &param_types, &return_type) || return_type != 'V') {
+            throw InvokeException(string("Malformed constructor signature \"") + constructor_sig + "\".");
+        }
+        if (param_types.size() != columns_.size()) {
+            throw InvokeException(string("Constructor \"") + constructor_sig + "\" does not take "
+                                  + to_string(columns_.size()) + " parameters.");
+        }
+        for (size_t i = 0; i < columns_.size(); i++) {
+            if (param_types[i] != columns_[i].type) {
+                throw InvokeException(string("Column ") + to_string(i) + " does not match constructor \""
+                                      + constructor_sig + "\".");
+            }
+        }
+        constructor_ = GetMethodID(env_, clz_, "<init>", constructor_sig);
+        args_.resize(columns_.size());
+    }
+
+    InstanceBuilder::InstanceBuilder(JNIEnv *env, jclass clz, const vector<FieldColumn> &columns) {
+        env_ = env;
+        clz_ = clz;
+        constructor_ = NULL;
+        for (size_t i = 0; i < columns.size(); i++) {
+            if (GetTypeChar(columns[i].sig) != columns[i].column.type) {
+                throw AccessException(string("Column of field \"") + columns[i].name + "\" does not match \""
+                                      + columns[i].sig + "\".");
+            }
+            field_ids_.push_back(GetFieldID(env_, clz_, columns[i].name, columns[i].sig));
+            columns_.push_back(columns[i].column);
+        }
+    }
+
+    jobjectArray InstanceBuilder::NewArray(jsize count) {
+        jobjectArray result = env_->NewObjectArray(count, clz_, NULL);
+        if (!result) {
+            env_->ExceptionClear();
+            throw Exception("Cannot allocate an object array.");
+        }
+        for (jsize start = 0; start < count; start += kChunkSize) {
+            LocalFrame frame(env_, kChunkSize);
+            jsize end = count - start < kChunkSize ? count : start + kChunkSize;
+            for (jsize i = start; i < end; i++) {
+                jobject instance = NewInstance(i);
+                env_->SetObjectArrayElement(result, i, instance);
+                env_->DeleteLocalRef(instance);
+            }
+        }
+        return result;
+    }
+
+    jobject InstanceBuilder::NewList(jsize count) {
+        jobjectArray array = NewArray(count);
+        jobject result = NewArrayList(env_, array);
+        env_->DeleteLocalRef(array);
+        return result;
+    }
+
+#pragma mark - Private
+
+    jobject InstanceBuilder::NewInstance(jsize index) {
+        if (constructor_) {
+            for (size_t i = 0; i < columns_.size(); i++) {
+                args_[i] = GetValue(columns_[i], index);
+            }
+            jobject result = env_->NewObjectA(clz_, constructor_, args_.empty() ? NULL : &args_[0]);
+            CheckCallMethodException(env_, "<init>", sig_.c_str());
+            return result;
+        }
+
+        jobject result = env_->AllocObject(clz_);
+        if (!result) {
+            env_->ExceptionClear();
+            throw InvokeException("Cannot allocate an instance.");
+        }
+        for (size_t i = 0; i < columns_.size(); i++) {
+            jvalue value = GetValue(columns_[i], index);
+            switch (columns_[i].type) {
+                case 'Z':
+                    env_->SetBooleanField(result, field_ids_[i], value.z);
+                    break;
+                case 'B':
+                    env_->SetByteField(result, field_ids_[i], value.b);
+                    break;
+                case 'C':
+                    env_->SetCharField(result, field_ids_[i], value.c);
+                    break;
+                case 'S':
+                    env_->SetShortField(result, field_ids_[i], value.s);
+                    break;
+                case 'I':
+                    env_->SetIntField(result, field_ids_[i], value.i);
+                    break;
+                case 'J':
+                    env_->SetLongField(result, field_ids_[i], value.j);
+                    break;
+                case 'F':
+                    env_->SetFloatField(result, field_ids_[i], value.f);
+                    break;
+                case 'D':
+                    env_->SetDoubleField(result, field_ids_[i], value.d);
+                    break;
+                default:
+                    env_->SetObjectField(result, field_ids_[i], value.l);
+                    break;
+            }
+        }
+        return result;
+    }
+}
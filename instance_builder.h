@@ -0,0 +1,97 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_INSTANCE_BUILDER_H
+#define NATIFLECT_INSTANCE_BUILDER_H
+
+#include <jni.h>
+#include <string>
+#include <vector>
+
+#include "exception.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // A column of native values with one value per instance to create.
+    struct Column {
+        Column(const jboolean *values) : type('Z'), values(values) { };
+
+        Column(const jbyte *values) : type('B'), values(values) { };
+
+        Column(const jchar *values) : type('C'), values(values) { };
+
+        Column(const jshort *values) : type('S'), values(values) { };
+
+        Column(const jint *values) : type('I'), values(values) { };
+
+        Column(const jlong *values) : type('J'), values(values) { };
+
+        Column(const jfloat *values) : type('F'), values(values) { };
+
+        Column(const jdouble *values) : type('D'), values(values) { };
+
+        Column(const jobject *values) : type('L'), values(values) { };
+
+        char type;
+        const void *values;
+    };
+
+    // A column written to an instance field.
+    struct FieldColumn {
+        FieldColumn(const char *name, const char *sig, Column column) : name(name), sig(sig), column(column) { };
+
+        const char *name;
+        const char *sig;
+        Column column;
+    };
+
+    // Creates many instances of a class from columnar native data. The constructor or fields are resolved
+    // once, and instances are created in chunks of local frames directly into a Java array or list.
+    class InstanceBuilder {
+    public:
+        // Column i is passed as parameter i of the constructor.
+        InstanceBuilder(JNIEnv *env, jclass clz, const char *constructor_sig, const vector<Column> &columns);
+
+        // Instances are allocated with AllocObject, without running any constructor, and the columns are
+        // written to their fields. This is cheaper for plain data classes whose constructors only assign fields.
+        InstanceBuilder(JNIEnv *env, jclass clz, const vector<FieldColumn> &columns);
+
+        // Creates instances from the first count values of each column.
+        jobjectArray NewArray(jsize count);
+
+        jobject NewList(jsize count);
+
+    private:
+        jobject NewInstance(jsize index);
+
+        JNIEnv *env_;
+        jclass clz_;
+        string sig_;
+        jmethodID constructor_;
+        vector<Column> columns_;
+        vector<jfieldID> field_ids_;
+        vector<jvalue> args_;
+    };
+}
+
+#endif //NATIFLECT_INSTANCE_BUILDER_H
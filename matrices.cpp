@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "matrices.h"
+
+#include <exception>
+#include <string>
+#include <thread>
+
+#include "ref_monitor.h"
+
+namespace natiflect {
+
+    jsize CheckMatrix(JNIEnv *env, jobjectArray array, char element_sig) {
+        if (!array) {
+            throw AccessException("The array is null.");
+        }
+        string sig = string("[[") + element_sig;
+        jclass matrix_class = env->FindClass(sig.c_str());
+        CheckNotFoundException(env, "class \"" + sig + "\"");
+        bool matches = env->IsInstanceOf(array, matrix_class) == JNI_TRUE;
+        env->DeleteLocalRef(matrix_class);
+        if (!matches) {
+            throw AccessException("The array is not of type \"" + sig + "\".");
+        }
+        return env->GetArrayLength(array);
+    }
+
+    jobjectArray NewRowArray(JNIEnv *env, jsize rows, char element_sig) {
+        string sig = string("[") + element_sig;
+        jclass row_class = env->FindClass(sig.c_str());
+        CheckNotFoundException(env, "class \"" + sig + "\"");
+        jobjectArray result = env->NewObjectArray(rows, row_class, NULL);
+        env->DeleteLocalRef(row_class);
+        if (!result) {
+            env->ExceptionClear();
+            throw Exception("Cannot allocate an array of " + to_string(rows) + " rows.");
+        }
+        return result;
+    }
+
+    jarray GetRow(JNIEnv *env, jobjectArray array, jsize index) {
+        jarray row = (jarray) env->GetObjectArrayElement(array, index);
+        if (!row) {
+            env->ExceptionClear();
+            throw AccessException("Row " + to_string(index) + " of the array is null.");
+        }
+        return row;
+    }
+
+    void ForEachRowRange(JNIEnv *env, jobjectArray array, size_t elements, int threads,
+                         const function<void(JNIEnv *, jobjectArray, jsize, jsize)> &fn) {
+        jsize rows = env->GetArrayLength(array);
+        if (threads > rows) {
+            threads = rows;
+        }
+        if (threads <= 1 || elements < kMinParallelMatrixElements) {
+            fn(env, array, 0, rows);
+            return;
+        }
+
+        JavaVM *vm;
+        if (env->GetJavaVM(&vm) != JNI_OK) {
+            throw Exception("Cannot get the JavaVM.");
+        }
+        jobjectArray shared = (jobjectArray) env->NewGlobalRef(array);
+        if (!shared) {
+            throw Exception("Cannot create a global reference to the array.");
+        }
+        RefMonitor::OnCreate(kGlobalRef, shared, "ForEachRowRange");
+
+        // The first failure of each thread is kept and rethrown as is.
+        vector<exception_ptr> errors((size_t) threads);
+        vector<thread> workers;
+        jsize rows_per_thread = (rows + threads - 1) / threads;
+        for (int t = 1; t < threads; t++) {
+            jsize begin = min(rows, t * rows_per_thread);
+            jsize end = min(rows, begin + rows_per_thread);
+            exception_ptr *error = &errors[t];
+            workers.push_back(thread([vm, shared, begin, end, error, &fn]() {
+                JNIEnv *worker_env = NULL;
+                if (vm->AttachCurrentThread((void **) &worker_env, NULL) != JNI_OK) {
+                    *error = make_exception_ptr(Exception("Cannot attach a copying thread to the VM."));
+                    return;
+                }
+                try {
+                    fn(worker_env, shared, begin, end);
+                } catch (...) {
+                    *error = current_exception();
+                }
+                worker_env->ExceptionClear();
+                vm->DetachCurrentThread();
+            }));
+        }
+        try {
+            fn(env, shared, 0, min(rows, rows_per_thread));
+        } catch (...) {
+            errors[0] = current_exception();
+        }
+        for (size_t i = 0; i < workers.size(); i++) {
+            workers[i].join();
+        }
+        RefMonitor::OnDelete(kGlobalRef, shared, "ForEachRowRange");
+        env->DeleteGlobalRef(shared);
+
+        for (size_t i = 0; i < errors.size(); i++) {
+            if (errors[i]) {
+                rethrow_exception(errors[i]);
+            }
+        }
+    }
+}
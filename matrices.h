@@ -0,0 +1,209 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_MATRICES_H
+#define NATIFLECT_MATRICES_H
+
+#include <jni.h>
+#include <stddef.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include "exception.h"
+#include "array_traits.h"
+#include "utils.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // Converters between two-dimensional Java arrays (E[][]) and contiguous native buffers. Each row is
+    // moved with one region copy straight into or out of the buffer, rows are walked in chunks of local
+    // frames, and large arrays can be split among several threads attached to the VM.
+
+    // Number of rows handled per local frame.
+    const jsize kMatrixChunkRows = 256;
+
+    // Arrays with fewer elements are always copied on the calling thread.
+    const size_t kMinParallelMatrixElements = 1 << 18;
+
+    // A rectangular matrix in row-major order.
+    template<typename E>
+    struct Matrix {
+        Matrix() : rows(0), columns(0) { };
+
+        jsize rows;
+        jsize columns;
+        vector<E> values;
+    };
+
+    // Rows of any length, stored back to back. Row i is values[offsets[i]] up to values[offsets[i + 1]],
+    // so there is one more offset than rows.
+    template<typename E>
+    struct RaggedMatrix {
+        RaggedMatrix() : offsets(1, 0) { };
+
+        jsize GetRows() const { return (jsize) offsets.size() - 1; };
+
+        vector<size_t> offsets;
+        vector<E> values;
+    };
+
+    // Checks that array is an E[][] whose element type has signature element_sig, and returns its length.
+    jsize CheckMatrix(JNIEnv *env, jobjectArray array, char element_sig);
+
+    jobjectArray NewRowArray(JNIEnv *env, jsize rows, char element_sig);
+
+    // Returns a local reference to a row, which must not be null.
+    jarray GetRow(JNIEnv *env, jobjectArray array, jsize index);
+
+    // Calls fn over ranges of the rows of array. With more than one thread and a large enough array,
+    // the rows are split among that many threads, each attached to the VM and given its own JNIEnv and
+    // a global reference to the array; otherwise fn runs once on the calling thread. Rethrows the
+    // first failure, with its original type, after all threads are done.
+    void ForEachRowRange(JNIEnv *env, jobjectArray array, size_t elements, int threads,
+                         const function<void(JNIEnv *, jobjectArray, jsize, jsize)> &fn);
+
+#pragma mark - Java To Native
+
+    template<typename E>
+    void GetRows(JNIEnv *env, jobjectArray array, jsize begin, jsize end, const size_t *offsets, E *values) {
+        for (jsize chunk = begin; chunk < end; chunk += kMatrixChunkRows) {
+            LocalFrame frame(env, kMatrixChunkRows);
+            jsize chunk_end = min(end, chunk + kMatrixChunkRows);
+            for (jsize i = chunk; i < chunk_end; i++) {
+                jarray row = GetRow(env, array, i);
+                jsize length = (jsize) (offsets[i + 1] - offsets[i]);
+                if (env->GetArrayLength(row) != length) {
+                    throw AccessException("A row of the array changed its length while being copied.");
+                }
+                if (length > 0) {
+                    ArrayTraits<E>::GetRegion(env, (typename ArrayTraits<E>::ArrayType) row, 0, length,
+                                              values + offsets[i]);
+                }
+                env->DeleteLocalRef(row);
+            }
+        }
+    }
+
+    template<typename E>
+    RaggedMatrix<E> ToRaggedMatrix(JNIEnv *env, jobjectArray array, int threads = 1) {
+        jsize rows = CheckMatrix(env, array, ArrayTraits<E>::kSig);
+        RaggedMatrix<E> result;
+        result.offsets.resize((size_t) rows + 1);
+        for (jsize chunk = 0; chunk < rows; chunk += kMatrixChunkRows) {
+            LocalFrame frame(env, kMatrixChunkRows);
+            jsize chunk_end = min(rows, chunk + kMatrixChunkRows);
+            for (jsize i = chunk; i < chunk_end; i++) {
+                jarray row = GetRow(env, array, i);
+                result.offsets[i + 1] = result.offsets[i] + env->GetArrayLength(row);
+                env->DeleteLocalRef(row);
+            }
+        }
+        result.values.resize(result.offsets[rows]);
+
+        const size_t *offsets = &result.offsets[0];
+        E *values = result.values.empty() ? NULL : &result.values[0];
+        ForEachRowRange(env, array, result.values.size(), threads,
+                        [offsets, values](JNIEnv *env, jobjectArray array, jsize begin, jsize end) {
+                            GetRows(env, array, begin, end, offsets, values);
+                        });
+        return result;
+    }
+
+    // Throws AccessException if the rows differ in length.
+    template<typename E>
+    Matrix<E> ToMatrix(JNIEnv *env, jobjectArray array, int threads = 1) {
+        RaggedMatrix<E> ragged = ToRaggedMatrix<E>(env, array, threads);
+        Matrix<E> result;
+        result.rows = ragged.GetRows();
+        result.columns = result.rows > 0 ? (jsize) ragged.offsets[1] : 0;
+        for (jsize i = 1; i < result.rows; i++) {
+            if (ragged.offsets[i + 1] - ragged.offsets[i] != (size_t) result.columns) {
+                throw AccessException("Row " + to_string(i) + " of the array differs in length from row 0; "
+                                      "use ToRaggedMatrix instead.");
+            }
+        }
+        result.values.swap(ragged.values);
+        return result;
+    }
+
+#pragma mark - Native To Java
+
+    template<typename E>
+    void NewRows(JNIEnv *env, jobjectArray array, jsize begin, jsize end, const size_t *offsets, const E *values) {
+        for (jsize chunk = begin; chunk < end; chunk += kMatrixChunkRows) {
+            LocalFrame frame(env, kMatrixChunkRows);
+            jsize chunk_end = min(end, chunk + kMatrixChunkRows);
+            for (jsize i = chunk; i < chunk_end; i++) {
+                jsize length = (jsize) (offsets[i + 1] - offsets[i]);
+                typename ArrayTraits<E>::ArrayType row = ArrayTraits<E>::NewArray(env, length);
+                if (!row) {
+                    env->ExceptionClear();
+                    throw Exception("Cannot allocate a row of the array.");
+                }
+                if (length > 0) {
+                    ArrayTraits<E>::SetRegion(env, row, 0, length, values + offsets[i]);
+                }
+                env->SetObjectArrayElement(array, i, row);
+                env->DeleteLocalRef(row);
+            }
+        }
+    }
+
+    template<typename E>
+    jobjectArray NewRaggedMatrix(JNIEnv *env, const RaggedMatrix<E> &matrix, int threads = 1) {
+        jsize rows = matrix.GetRows();
+        jobjectArray result = NewRowArray(env, rows, ArrayTraits<E>::kSig);
+        const size_t *offsets = &matrix.offsets[0];
+        const E *values = matrix.values.empty() ? NULL : &matrix.values[0];
+        ForEachRowRange(env, result, matrix.values.size(), threads,
+                        [offsets, values](JNIEnv *env, jobjectArray array, jsize begin, jsize end) {
+                            NewRows(env, array, begin, end, offsets, values);
+                        });
+        return result;
+    }
+
+    // values holds rows * columns elements in row-major order.
+    template<typename E>
+    jobjectArray NewMatrix(JNIEnv *env, const E *values, jsize rows, jsize columns, int threads = 1) {
+        vector<size_t> offsets((size_t) rows + 1);
+        for (jsize i = 0; i <= rows; i++) {
+            offsets[i] = (size_t) i * columns;
+        }
+        jobjectArray result = NewRowArray(env, rows, ArrayTraits<E>::kSig);
+        const size_t *row_offsets = &offsets[0];
+        ForEachRowRange(env, result, offsets[rows], threads,
+                        [row_offsets, values](JNIEnv *env, jobjectArray array, jsize begin, jsize end) {
+                            NewRows(env, array, begin, end, row_offsets, values);
+                        });
+        return result;
+    }
+
+    template<typename E>
+    jobjectArray NewMatrix(JNIEnv *env, const Matrix<E> &matrix, int threads = 1) {
+        return NewMatrix(env, matrix.values.empty() ? NULL : &matrix.values[0], matrix.rows, matrix.columns,
+                         threads);
+    }
+}
+
+#endif //NATIFLECT_MATRICES_H
@@ -0,0 +1,55 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_MEMBER_KEY_H
+#define NATIFLECT_MEMBER_KEY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>
+
+namespace natiflect {
+
+    constexpr uint64_t HashChars(const char *s, uint64_t hash) {
+        return *s ? HashChars(s + 1, (hash ^ (unsigned char) *s) * 1099511628211ULL) : hash;
+    }
+
+    // Same as HashMember() in utils.h, at compile time.
+    constexpr uint64_t ConstHashMember(const char *name, const char *sig) {
+        return HashChars(sig, HashChars(name, 14695981039346656037ULL) * 1099511628211ULL);
+    }
+
+    // A member name and signature with their hash computed at compile time, so that looking up
+    // a cached member does not hash any string. Create keys with NF_MEMBER.
+    struct MemberKey {
+        constexpr MemberKey(const char *name, const char *sig, uint64_t hash) : name(name), sig(sig), hash(hash) { };
+
+        const char *name;
+        const char *sig;
+        uint64_t hash;
+    };
+}
+
+#define NF_MEMBER(name, sig) \
+    (::natiflect::MemberKey((name), (sig), \
+        ::std::integral_constant<uint64_t, ::natiflect::ConstHashMember((name), (sig))>::value))
+
+#endif //NATIFLECT_MEMBER_KEY_H
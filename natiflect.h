@@ -26,7 +26,25 @@
 #define NATIFLECT_NATIFLECT_H
 
 #include "exception.h"
+#include "array_kernels.h"
+#include "boxing.h"
+#include "cache.h"
+#include "call_site.h"
 #include "class.h"
+#include "class_index.h"
+#include "collections.h"
+#include "constants.h"
+#include "enum_bridge.h"
+#include "event_queue.h"
+#include "field_batch.h"
+#include "graph_snapshot.h"
+#include "instance_builder.h"
+#include "matrices.h"
+#include "member_key.h"
 #include "object.h"
+#include "ref_monitor.h"
+#include "string_pool.h"
+#include "vm.h"
+#include "warmup.h"
 
 #endif //NATIFLECT_NATIFLECT_H
@@ -25,7 +25,12 @@
 #include "object.h"
 
 #include "utils.h"
+#include "checked.h"
 #include "class.h"
+#include "boxing.h"
+#include "cache.h"
+#include "ref_monitor.h"
+#include "vm.h"
 
 namespace natiflect {
 
@@ -35,6 +40,7 @@ namespace natiflect {
         val_ = val;
         clz_ = env_->GetObjectClass(val_);
         CheckNotFoundException(env_, "class of the object");
+        RefMonitor::OnCreate(kLocalRef, clz_, "Object::GetObjectClass");
     }
 
     template<typename T>
@@ -46,6 +52,13 @@ namespace natiflect {
         val_ = (T) clz.NewInstanceV(constructor_sig, args);
     }
 
+    template<typename T>
+    Object<T>::Object(JNIEnv *env, T val, jclass clz) {
+        env_ = env;
+        val_ = val;
+        clz_ = clz;
+    }
+
 #pragma mark - Base
 
     template<typename T>
@@ -58,6 +71,7 @@ namespace natiflect {
         val_ = val;
         clz_ = env_->GetObjectClass(val_);
         CheckNotFoundException(env_, "class of the object");
+        RefMonitor::OnCreate(kLocalRef, clz_, "Object::GetObjectClass");
     };
 
     template<typename T>
@@ -75,121 +89,309 @@ namespace natiflect {
         return env_->IsSameObject(val_, other);
     }
 
+    template<typename T>
+    bool Object<T>::Is(const char *class_name) {
+        return Is(class_name, HashMember(class_name, ""));
+    }
+
+    template<typename T>
+    bool Object<T>::Is(const char *class_name, uint64_t hash) {
+        TypeCache &cache = TypeCache::GetInstance();
+        int cached = cache.Find(env_, clz_, class_name, hash);
+        if (cached >= 0) {
+            return cached == 1;
+        }
+
+        bool assignable;
+        if (class_name[0] == '[' && class_name[1] == '\0') {
+            assignable = GetClassName(env_, clz_)[0] == '[';
+            cache.Put(env_, clz_, class_name, hash, assignable);
+            return assignable;
+        }
+
+        // The answer is only cached for targets of the bootstrap loader, which ClassCache holds, since other
+        // names may resolve to different classes depending on the calling native method.
+        jclass target = ClassCache::GetInstance().Find(env_, class_name);
+        bool cacheable = target != NULL;
+        if (!target) {
+            target = env_->FindClass(class_name);
+            CheckNotFoundException(env_, string("class \"") + class_name + "\"");
+            cacheable = ClassCache::GetInstance().Put(env_, class_name, target);
+        }
+        assignable = env_->IsAssignableFrom(clz_, target) == JNI_TRUE;
+        env_->DeleteLocalRef(target);
+        if (cacheable) {
+            cache.Put(env_, clz_, class_name, hash, assignable);
+        }
+        return assignable;
+    }
+
+    template<typename T>
+    bool Object<T>::Is(Class clz) {
+        return env_->IsAssignableFrom(clz_, clz.GetJClass()) == JNI_TRUE;
+    }
+
 #pragma mark - Instance Method
 
     template<typename T>
     void Object<T>::Call_V(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'V');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         env_->CallVoidMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
     }
 
     template<typename T>
     jboolean Object<T>::Call_Z(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'Z');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jboolean result = env_->CallBooleanMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jbyte Object<T>::Call_B(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'B');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jbyte result = env_->CallByteMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jchar Object<T>::Call_C(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'C');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jchar result = env_->CallCharMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jshort Object<T>::Call_S(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'S');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jshort result = env_->CallShortMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jint Object<T>::Call_I(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'I');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jint result = env_->CallIntMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jlong Object<T>::Call_J(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'J');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jlong result = env_->CallLongMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jfloat Object<T>::Call_F(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'F');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jfloat result = env_->CallFloatMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jdouble Object<T>::Call_D(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'D');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jdouble result = env_->CallDoubleMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
         return result;
     }
 
     template<typename T>
     jobject Object<T>::Call_L(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
         jmethodID method_id = GetMethodID(env_, clz_, name, sig);
         va_list args;
         va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
         jobject result = env_->CallObjectMethodV(val_, method_id, args);
         va_end(args);
         CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Object::Call_L");
         return result;
     }
 
+#pragma mark - Instance Method Returning Boxed Value
+
+    template<typename T>
+    jboolean Object<T>::CallUnboxed_Z(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_Z);
+    }
+
+    template<typename T>
+    jbyte Object<T>::CallUnboxed_B(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_B);
+    }
+
+    template<typename T>
+    jchar Object<T>::CallUnboxed_C(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_C);
+    }
+
+    template<typename T>
+    jshort Object<T>::CallUnboxed_S(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_S);
+    }
+
+    template<typename T>
+    jint Object<T>::CallUnboxed_I(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_I);
+    }
+
+    template<typename T>
+    jlong Object<T>::CallUnboxed_J(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_J);
+    }
+
+    template<typename T>
+    jfloat Object<T>::CallUnboxed_F(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_F);
+    }
+
+    template<typename T>
+    jdouble Object<T>::CallUnboxed_D(const char *name, const char *sig, ...) {
+        NF_CHECK_CALL(env_, val_, name, sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, name, sig);
+        va_list args;
+        va_start(args, sig);
+        NF_CHECK_ARGUMENTS(env_, name, sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, name, sig);
+        Vm::OnCall();
+        return UnboxLocalRef(env_, result, Unbox_D);
+    }
+
 #pragma mark - Instance Field
 
     template<typename T>
     jboolean Object<T>::Get_Z(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "Z", 'Z');
         jfieldID field_id = GetFieldID(env_, clz_, name, "Z");
         jboolean result = env_->GetBooleanField(val_, field_id);
         CheckAccessFieldException(env_, name, "Z");
@@ -198,6 +400,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_Z(const char *name, jboolean value) {
+        NF_CHECK_FIELD(env_, val_, name, "Z", 'Z');
         jfieldID field_id = GetFieldID(env_, clz_, name, "Z");
         env_->SetBooleanField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "Z");
@@ -205,6 +408,7 @@ namespace natiflect {
 
     template<typename T>
     jbyte Object<T>::Get_B(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "B", 'B');
         jfieldID field_id = GetFieldID(env_, clz_, name, "B");
         jbyte result = env_->GetByteField(val_, field_id);
         CheckAccessFieldException(env_, name, "B");
@@ -213,6 +417,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_B(const char *name, jbyte value) {
+        NF_CHECK_FIELD(env_, val_, name, "B", 'B');
         jfieldID field_id = GetFieldID(env_, clz_, name, "B");
         env_->SetByteField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "B");
@@ -220,6 +425,7 @@ namespace natiflect {
 
     template<typename T>
     jchar Object<T>::Get_C(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "C", 'C');
         jfieldID field_id = GetFieldID(env_, clz_, name, "C");
         jchar result = env_->GetCharField(val_, field_id);
         CheckAccessFieldException(env_, name, "C");
@@ -228,6 +434,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_C(const char *name, jchar value) {
+        NF_CHECK_FIELD(env_, val_, name, "C", 'C');
         jfieldID field_id = GetFieldID(env_, clz_, name, "C");
         env_->SetCharField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "C");
@@ -235,6 +442,7 @@ namespace natiflect {
 
     template<typename T>
     jshort Object<T>::Get_S(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "S", 'S');
         jfieldID field_id = GetFieldID(env_, clz_, name, "S");
         jshort result = env_->GetShortField(val_, field_id);
         CheckAccessFieldException(env_, name, "S");
@@ -243,6 +451,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_S(const char *name, jshort value) {
+        NF_CHECK_FIELD(env_, val_, name, "S", 'S');
         jfieldID field_id = GetFieldID(env_, clz_, name, "S");
         env_->SetShortField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "S");
@@ -250,6 +459,7 @@ namespace natiflect {
 
     template<typename T>
     jint Object<T>::Get_I(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "I", 'I');
         jfieldID field_id = GetFieldID(env_, clz_, name, "I");
         jint result = env_->GetIntField(val_, field_id);
         CheckAccessFieldException(env_, name, "I");
@@ -258,6 +468,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_I(const char *name, jint value) {
+        NF_CHECK_FIELD(env_, val_, name, "I", 'I');
         jfieldID field_id = GetFieldID(env_, clz_, name, "I");
         env_->SetIntField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "I");
@@ -265,6 +476,7 @@ namespace natiflect {
 
     template<typename T>
     jlong Object<T>::Get_J(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "J", 'J');
         jfieldID field_id = GetFieldID(env_, clz_, name, "J");
         jlong result = env_->GetLongField(val_, field_id);
         CheckAccessFieldException(env_, name, "J");
@@ -273,6 +485,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_J(const char *name, jlong value) {
+        NF_CHECK_FIELD(env_, val_, name, "J", 'J');
         jfieldID field_id = GetFieldID(env_, clz_, name, "J");
         env_->SetLongField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "J");
@@ -280,6 +493,7 @@ namespace natiflect {
 
     template<typename T>
     jfloat Object<T>::Get_F(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "F", 'F');
         jfieldID field_id = GetFieldID(env_, clz_, name, "F");
         jfloat result = env_->GetFloatField(val_, field_id);
         CheckAccessFieldException(env_, name, "F");
@@ -288,6 +502,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_F(const char *name, jfloat value) {
+        NF_CHECK_FIELD(env_, val_, name, "F", 'F');
         jfieldID field_id = GetFieldID(env_, clz_, name, "F");
         env_->SetFloatField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "F");
@@ -295,6 +510,7 @@ namespace natiflect {
 
     template<typename T>
     jdouble Object<T>::Get_D(const char *name) {
+        NF_CHECK_FIELD(env_, val_, name, "D", 'D');
         jfieldID field_id = GetFieldID(env_, clz_, name, "D");
         jdouble result = env_->GetDoubleField(val_, field_id);
         CheckAccessFieldException(env_, name, "D");
@@ -303,6 +519,7 @@ namespace natiflect {
 
     template<typename T>
     void Object<T>::Set_D(const char *name, jdouble value) {
+        NF_CHECK_FIELD(env_, val_, name, "D", 'D');
         jfieldID field_id = GetFieldID(env_, clz_, name, "D");
         env_->SetDoubleField(val_, field_id, value);
         CheckAccessFieldException(env_, name, "D");
@@ -310,18 +527,466 @@ namespace natiflect {
 
     template<typename T>
     jobject Object<T>::Get_L(const char *name, const char *sig) {
+        NF_CHECK_FIELD(env_, val_, name, sig, 'L');
         jfieldID field_id = GetFieldID(env_, clz_, name, sig);
         jobject result = env_->GetObjectField(val_, field_id);
         CheckAccessFieldException(env_, name, sig);
+        RefMonitor::OnCreate(kLocalRef, result, "Object::Get_L");
         return result;
     }
 
     template<typename T>
     void Object<T>::Set_L(const char *name, const char *sig, jobject value) {
+        NF_CHECK_FIELD(env_, val_, name, sig, 'L');
         jfieldID field_id = GetFieldID(env_, clz_, name, sig);
         env_->SetObjectField(val_, field_id, value);
         CheckAccessFieldException(env_, name, sig);
     }
+
+    template<typename T>
+    FieldBatch Object<T>::NewFieldBatch() {
+        return FieldBatch(env_, clz_);
+    }
+
+#pragma mark - Instance Method With Member Key
+
+    template<typename T>
+    void Object<T>::Call_V(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'V');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        env_->CallVoidMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+    }
+
+    template<typename T>
+    jboolean Object<T>::Call_Z(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'Z');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jboolean result = env_->CallBooleanMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jbyte Object<T>::Call_B(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'B');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jbyte result = env_->CallByteMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jchar Object<T>::Call_C(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'C');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jchar result = env_->CallCharMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jshort Object<T>::Call_S(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'S');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jshort result = env_->CallShortMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jint Object<T>::Call_I(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'I');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jint result = env_->CallIntMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jlong Object<T>::Call_J(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'J');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jlong result = env_->CallLongMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jfloat Object<T>::Call_F(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'F');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jfloat result = env_->CallFloatMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jdouble Object<T>::Call_D(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'D');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jdouble result = env_->CallDoubleMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jobject Object<T>::Call_L(MemberKey key, ...) {
+        NF_CHECK_CALL(env_, val_, key.name, key.sig, 'L');
+        jmethodID method_id = GetMethodID(env_, clz_, key);
+        va_list args;
+        va_start(args, key);
+        NF_CHECK_ARGUMENTS(env_, key.name, key.sig, args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, key.name, key.sig);
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Object::Call_L");
+        return result;
+    }
+
+#pragma mark - Instance Method With Call Site
+
+    template<typename T>
+    void Object<T>::Call_V(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'V');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        env_->CallVoidMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+    }
+
+    template<typename T>
+    jboolean Object<T>::Call_Z(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'Z');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jboolean result = env_->CallBooleanMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jbyte Object<T>::Call_B(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'B');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jbyte result = env_->CallByteMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jchar Object<T>::Call_C(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'C');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jchar result = env_->CallCharMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jshort Object<T>::Call_S(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'S');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jshort result = env_->CallShortMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jint Object<T>::Call_I(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'I');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jint result = env_->CallIntMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jlong Object<T>::Call_J(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'J');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jlong result = env_->CallLongMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jfloat Object<T>::Call_F(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'F');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jfloat result = env_->CallFloatMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jdouble Object<T>::Call_D(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'D');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jdouble result = env_->CallDoubleMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        return result;
+    }
+
+    template<typename T>
+    jobject Object<T>::Call_L(CallSite *site, ...) {
+        NF_CHECK_CALL(env_, val_, site->GetName(), site->GetSignature(), 'L');
+        jmethodID method_id = site->GetMethodID(env_, clz_);
+        va_list args;
+        va_start(args, site);
+        NF_CHECK_ARGUMENTS(env_, site->GetName(), site->GetSignature(), args);
+        jobject result = env_->CallObjectMethodV(val_, method_id, args);
+        va_end(args);
+        CheckCallMethodException(env_, site->GetName(), site->GetSignature());
+        Vm::OnCall();
+        RefMonitor::OnCreate(kLocalRef, result, "Object::Call_L");
+        return result;
+    }
+
+#pragma mark - Instance Field With Member Key
+
+    template<typename T>
+    jboolean Object<T>::Get_Z(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'Z');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jboolean result = env_->GetBooleanField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_Z(MemberKey key, jboolean value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'Z');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetBooleanField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jbyte Object<T>::Get_B(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'B');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jbyte result = env_->GetByteField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_B(MemberKey key, jbyte value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'B');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetByteField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jchar Object<T>::Get_C(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'C');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jchar result = env_->GetCharField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_C(MemberKey key, jchar value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'C');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetCharField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jshort Object<T>::Get_S(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'S');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jshort result = env_->GetShortField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_S(MemberKey key, jshort value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'S');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetShortField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jint Object<T>::Get_I(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'I');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jint result = env_->GetIntField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_I(MemberKey key, jint value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'I');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetIntField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jlong Object<T>::Get_J(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'J');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jlong result = env_->GetLongField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_J(MemberKey key, jlong value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'J');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetLongField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jfloat Object<T>::Get_F(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'F');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jfloat result = env_->GetFloatField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_F(MemberKey key, jfloat value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'F');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetFloatField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jdouble Object<T>::Get_D(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'D');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jdouble result = env_->GetDoubleField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_D(MemberKey key, jdouble value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'D');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetDoubleField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
+
+    template<typename T>
+    jobject Object<T>::Get_L(MemberKey key) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'L');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        jobject result = env_->GetObjectField(val_, field_id);
+        CheckAccessFieldException(env_, key.name, key.sig);
+        RefMonitor::OnCreate(kLocalRef, result, "Object::Get_L");
+        return result;
+    }
+
+    template<typename T>
+    void Object<T>::Set_L(MemberKey key, jobject value) {
+        NF_CHECK_FIELD(env_, val_, key.name, key.sig, 'L');
+        jfieldID field_id = GetFieldID(env_, clz_, key);
+        env_->SetObjectField(val_, field_id, value);
+        CheckAccessFieldException(env_, key.name, key.sig);
+    }
 }
 
 #include "object_template_explicit.h"
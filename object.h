@@ -26,13 +26,93 @@
 #define NATIFLECT_OBJECT_H
 
 #include <jni.h>
+#include <stdint.h>
+#include <type_traits>
 
+#include "call_site.h"
 #include "exception.h"
+#include "field_batch.h"
+#include "member_key.h"
 
 namespace natiflect {
 
     class Class;
 
+    // The class each Object<T> specialization stands for, as used by Object<T>::Is<U>() and As<U>().
+    // jarray stands for arrays of any type, written "[".
+    template<typename T>
+    struct JavaType;
+
+    template<>
+    struct JavaType<jobject> {
+        static constexpr const char *GetName() { return "java/lang/Object"; };
+    };
+
+    template<>
+    struct JavaType<jclass> {
+        static constexpr const char *GetName() { return "java/lang/Class"; };
+    };
+
+    template<>
+    struct JavaType<jstring> {
+        static constexpr const char *GetName() { return "java/lang/String"; };
+    };
+
+    template<>
+    struct JavaType<jthrowable> {
+        static constexpr const char *GetName() { return "java/lang/Throwable"; };
+    };
+
+    template<>
+    struct JavaType<jarray> {
+        static constexpr const char *GetName() { return "["; };
+    };
+
+    template<>
+    struct JavaType<jobjectArray> {
+        static constexpr const char *GetName() { return "[Ljava/lang/Object;"; };
+    };
+
+    template<>
+    struct JavaType<jbooleanArray> {
+        static constexpr const char *GetName() { return "[Z"; };
+    };
+
+    template<>
+    struct JavaType<jbyteArray> {
+        static constexpr const char *GetName() { return "[B"; };
+    };
+
+    template<>
+    struct JavaType<jcharArray> {
+        static constexpr const char *GetName() { return "[C"; };
+    };
+
+    template<>
+    struct JavaType<jshortArray> {
+        static constexpr const char *GetName() { return "[S"; };
+    };
+
+    template<>
+    struct JavaType<jintArray> {
+        static constexpr const char *GetName() { return "[I"; };
+    };
+
+    template<>
+    struct JavaType<jlongArray> {
+        static constexpr const char *GetName() { return "[J"; };
+    };
+
+    template<>
+    struct JavaType<jfloatArray> {
+        static constexpr const char *GetName() { return "[F"; };
+    };
+
+    template<>
+    struct JavaType<jdoubleArray> {
+        static constexpr const char *GetName() { return "[D"; };
+    };
+
     template<typename T>
     class Object {
     public:
@@ -52,6 +132,20 @@ namespace natiflect {
 
         bool Equals(jobject other);
 
+        // Whether the object is an instance of a class given by name, such as "java/lang/String" or "[I".
+        // Results are cached per class of the object, so repeated checks cost a table lookup.
+        bool Is(const char *class_name);
+
+        // A single IsAssignableFrom call, not cached; prefer class names on hot paths.
+        bool Is(Class clz);
+
+        template<typename U>
+        bool Is();
+
+        // Returns the object as an Object<U>, sharing its class, or throws CastException if it is not one.
+        template<typename U>
+        Object<U> As();
+
 #pragma mark - Instance Method
 
         void Call_V(const char *name, const char *sig = "()V", ...);
@@ -74,6 +168,24 @@ namespace natiflect {
 
         jobject Call_L(const char *name, const char *sig, ...);
 
+#pragma mark - Instance Method Returning Boxed Value
+
+        jboolean CallUnboxed_Z(const char *name, const char *sig, ...);
+
+        jbyte CallUnboxed_B(const char *name, const char *sig, ...);
+
+        jchar CallUnboxed_C(const char *name, const char *sig, ...);
+
+        jshort CallUnboxed_S(const char *name, const char *sig, ...);
+
+        jint CallUnboxed_I(const char *name, const char *sig, ...);
+
+        jlong CallUnboxed_J(const char *name, const char *sig, ...);
+
+        jfloat CallUnboxed_F(const char *name, const char *sig, ...);
+
+        jdouble CallUnboxed_D(const char *name, const char *sig, ...);
+
 #pragma mark - Instance Field
 
         jboolean Get_Z(const char *name);
@@ -112,13 +224,121 @@ namespace natiflect {
 
         void Set_L(const char *name, const char *sig, jobject value);
 
+        // A batch of writes to fields of this object's class, see FieldBatch.
+        FieldBatch NewFieldBatch();
+
+#pragma mark - Instance Method With Member Key
+
+        void Call_V(MemberKey key, ...);
+
+        jboolean Call_Z(MemberKey key, ...);
+
+        jbyte Call_B(MemberKey key, ...);
+
+        jchar Call_C(MemberKey key, ...);
+
+        jshort Call_S(MemberKey key, ...);
+
+        jint Call_I(MemberKey key, ...);
+
+        jlong Call_J(MemberKey key, ...);
+
+        jfloat Call_F(MemberKey key, ...);
+
+        jdouble Call_D(MemberKey key, ...);
+
+        jobject Call_L(MemberKey key, ...);
+
+#pragma mark - Instance Method With Call Site
+
+        void Call_V(CallSite *site, ...);
+
+        jboolean Call_Z(CallSite *site, ...);
+
+        jbyte Call_B(CallSite *site, ...);
+
+        jchar Call_C(CallSite *site, ...);
+
+        jshort Call_S(CallSite *site, ...);
+
+        jint Call_I(CallSite *site, ...);
+
+        jlong Call_J(CallSite *site, ...);
+
+        jfloat Call_F(CallSite *site, ...);
+
+        jdouble Call_D(CallSite *site, ...);
+
+        jobject Call_L(CallSite *site, ...);
+
+#pragma mark - Instance Field With Member Key
+
+        jboolean Get_Z(MemberKey key);
+
+        void Set_Z(MemberKey key, jboolean value);
+
+        jbyte Get_B(MemberKey key);
+
+        void Set_B(MemberKey key, jbyte value);
+
+        jchar Get_C(MemberKey key);
+
+        void Set_C(MemberKey key, jchar value);
+
+        jshort Get_S(MemberKey key);
+
+        void Set_S(MemberKey key, jshort value);
+
+        jint Get_I(MemberKey key);
+
+        void Set_I(MemberKey key, jint value);
+
+        jlong Get_J(MemberKey key);
+
+        void Set_J(MemberKey key, jlong value);
+
+        jfloat Get_F(MemberKey key);
+
+        void Set_F(MemberKey key, jfloat value);
+
+        jdouble Get_D(MemberKey key);
+
+        void Set_D(MemberKey key, jdouble value);
+
+        jobject Get_L(MemberKey key);
+
+        void Set_L(MemberKey key, jobject value);
+
     protected:
+        template<typename U>
+        friend class Object;
+
         Object() { };
 
+        Object(JNIEnv *env, T val, jclass clz);
+
+        bool Is(const char *class_name, uint64_t hash);
+
         JNIEnv *env_;
         T val_;
         jclass clz_;
     };
+
+    template<typename T>
+    template<typename U>
+    bool Object<T>::Is() {
+        return Is(JavaType<U>::GetName(),
+                  integral_constant<uint64_t, ConstHashMember(JavaType<U>::GetName(), "")>::value);
+    }
+
+    template<typename T>
+    template<typename U>
+    Object<U> Object<T>::As() {
+        if (!Is<U>()) {
+            throw CastException(string("The object is not an instance of \"") + JavaType<U>::GetName() + "\".");
+        }
+        return Object<U>(env_, (U) val_, clz_);
+    }
 }
 
 #endif //NATIFLECT_OBJECT_H
@@ -0,0 +1,234 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "ref_monitor.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace natiflect {
+
+    namespace {
+
+        // Local references of a thread beyond this many are assumed released by the return of a native
+        // method without a LocalScope, or by a frame popped outside natiflect, which cannot be observed.
+        const size_t kMaxTrackedLocals = 1024;
+
+        struct Counters {
+            atomic<int64_t> live;
+            atomic<int64_t> high_water;
+            atomic<uint64_t> created;
+            atomic<uint64_t> deleted;
+            atomic<int64_t> threshold;
+            atomic<RefThresholdCallback> callback;
+        };
+
+        Counters counters[kRefKindCount];
+
+        struct LocalRecord {
+            jobject ref;
+            const char *tag;
+        };
+
+        struct ThreadState {
+            ThreadState() : base(0), high_water(0), created(0), deleted(0) { };
+
+            // The live local references of an exiting thread are gone with it.
+            ~ThreadState() {
+                Release(locals.size());
+            }
+
+            // Accounts for the oldest count live local references as deleted.
+            void Release(size_t count) {
+                if (count == 0) {
+                    return;
+                }
+                locals.erase(locals.begin(), locals.begin() + count);
+                base += (int64_t) count;
+                deleted += count;
+                counters[kLocalRef].deleted.fetch_add((uint64_t) count, memory_order_relaxed);
+                counters[kLocalRef].live.fetch_sub((int64_t) count, memory_order_relaxed);
+            }
+
+            // The live local references, oldest first, so a popped frame truncates it. Positions saved
+            // by EnterFrame count from the first reference ever recorded; base of them have been dropped.
+            vector<LocalRecord> locals;
+            int64_t base;
+            int64_t high_water;
+            uint64_t created;
+            uint64_t deleted;
+        };
+
+        // Live global and weak global references by tag.
+        mutex tags_mutex;
+        unordered_map<const char *, int64_t> global_tags[kRefKindCount];
+
+        thread_local ThreadState thread_state;
+
+        void UpdateHighWater(atomic<int64_t> &high_water, int64_t value) {
+            int64_t current = high_water.load(memory_order_relaxed);
+            while (value > current && !high_water.compare_exchange_weak(current, value, memory_order_relaxed)) {
+            }
+        }
+
+        void CheckThreshold(RefKind kind, int64_t previous, int64_t live, const char *tag) {
+            int64_t threshold = counters[kind].threshold.load(memory_order_relaxed);
+            if (threshold > 0 && previous <= threshold && live > threshold) {
+                RefThresholdCallback callback = counters[kind].callback.load(memory_order_acquire);
+                if (callback) {
+                    callback(kind, live, tag);
+                }
+            }
+        }
+
+        RefCounts LoadCounts(const Counters &source) {
+            RefCounts counts;
+            counts.live = source.live.load(memory_order_relaxed);
+            counts.high_water = source.high_water.load(memory_order_relaxed);
+            counts.created = source.created.load(memory_order_relaxed);
+            counts.deleted = source.deleted.load(memory_order_relaxed);
+            return counts;
+        }
+    }
+
+    atomic<bool> RefMonitor::enabled_(false);
+
+    void RefMonitor::SetEnabled(bool enabled) {
+        enabled_.store(enabled, memory_order_relaxed);
+    }
+
+    void RefMonitor::Record(RefKind kind, jobject ref, const char *tag, int64_t delta) {
+        Counters &target = counters[kind];
+        if (kind == kLocalRef) {
+            ThreadState &state = thread_state;
+            if (delta > 0) {
+                if (state.locals.size() >= kMaxTrackedLocals) {
+                    state.Release(kMaxTrackedLocals / 2);
+                }
+                int64_t previous = (int64_t) state.locals.size();
+                LocalRecord record = {ref, tag};
+                state.locals.push_back(record);
+                state.created++;
+                if (previous + 1 > state.high_water) {
+                    state.high_water = previous + 1;
+                    UpdateHighWater(target.high_water, state.high_water);
+                }
+                target.created.fetch_add(1, memory_order_relaxed);
+                target.live.fetch_add(1, memory_order_relaxed);
+                CheckThreshold(kind, previous, previous + 1, tag);
+            } else {
+                // Usually the most recent one. Not found if it has already been accounted for.
+                for (size_t i = state.locals.size(); i > 0; i--) {
+                    if (state.locals[i - 1].ref == ref) {
+                        state.locals.erase(state.locals.begin() + (i - 1));
+                        state.deleted++;
+                        target.deleted.fetch_add(1, memory_order_relaxed);
+                        target.live.fetch_sub(1, memory_order_relaxed);
+                        break;
+                    }
+                }
+            }
+            return;
+        }
+
+        int64_t previous = target.live.fetch_add(delta, memory_order_relaxed);
+        if (delta > 0) {
+            target.created.fetch_add(1, memory_order_relaxed);
+            UpdateHighWater(target.high_water, previous + delta);
+        } else {
+            target.deleted.fetch_add(1, memory_order_relaxed);
+        }
+        {
+            lock_guard<mutex> lock(tags_mutex);
+            int64_t &live = global_tags[kind][tag];
+            live += delta;
+            if (live == 0) {
+                global_tags[kind].erase(tag);
+            }
+        }
+        if (delta > 0) {
+            CheckThreshold(kind, previous, previous + delta, tag);
+        }
+    }
+
+    int64_t RefMonitor::EnterFrame() {
+        ThreadState &state = thread_state;
+        return state.base + (int64_t) state.locals.size();
+    }
+
+    void RefMonitor::LeaveFrame(int64_t saved) {
+        ThreadState &state = thread_state;
+        int64_t kept = saved > state.base ? saved - state.base : 0;
+        int64_t released = (int64_t) state.locals.size() - kept;
+        if (released <= 0) {
+            return;
+        }
+        state.locals.resize((size_t) kept);
+        state.deleted += released;
+        counters[kLocalRef].deleted.fetch_add((uint64_t) released, memory_order_relaxed);
+        counters[kLocalRef].live.fetch_sub(released, memory_order_relaxed);
+    }
+
+    RefCounts RefMonitor::GetCounts(RefKind kind) {
+        return LoadCounts(counters[kind]);
+    }
+
+    RefCounts RefMonitor::GetThreadCounts(RefKind kind) {
+        if (kind != kLocalRef) {
+            return LoadCounts(counters[kind]);
+        }
+        ThreadState &state = thread_state;
+        RefCounts counts;
+        counts.live = (int64_t) state.locals.size();
+        counts.high_water = state.high_water;
+        counts.created = state.created;
+        counts.deleted = state.deleted;
+        return counts;
+    }
+
+    vector<RefLeak> RefMonitor::GetLeakReport() {
+        vector<RefLeak> result;
+        unordered_map<const char *, int64_t> local_tags;
+        const vector<LocalRecord> &locals = thread_state.locals;
+        for (size_t i = 0; i < locals.size(); i++) {
+            local_tags[locals[i].tag]++;
+        }
+        for (unordered_map<const char *, int64_t>::iterator it = local_tags.begin(); it != local_tags.end(); ++it) {
+            RefLeak leak = {kLocalRef, it->first, it->second};
+            result.push_back(leak);
+        }
+
+        lock_guard<mutex> lock(tags_mutex);
+        for (int kind = kGlobalRef; kind < kRefKindCount; kind++) {
+            unordered_map<const char *, int64_t>::iterator it = global_tags[kind].begin();
+            for (; it != global_tags[kind].end(); ++it) {
+                RefLeak leak = {(RefKind) kind, it->first, it->second};
+                result.push_back(leak);
+            }
+        }
+        return result;
+    }
+
+    void RefMonitor::SetThreshold(RefKind kind, int64_t threshold, RefThresholdCallback callback) {
+        counters[kind].callback.store(callback, memory_order_release);
+        counters[kind].threshold.store(threshold, memory_order_relaxed);
+    }
+}
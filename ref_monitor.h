@@ -0,0 +1,131 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_REF_MONITOR_H
+#define NATIFLECT_REF_MONITOR_H
+
+#include <jni.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+namespace natiflect {
+
+    enum RefKind {
+        kLocalRef,
+        kGlobalRef,
+        kWeakGlobalRef,
+        kRefKindCount
+    };
+
+    struct RefCounts {
+        // Local references are counted per thread, and the process-wide numbers add up all threads,
+        // except high_water which is the highest of any single thread.
+        int64_t live;
+        int64_t high_water;
+        uint64_t created;
+        uint64_t deleted;
+    };
+
+    struct RefLeak {
+        RefKind kind;
+        const char *tag;
+        int64_t live;
+    };
+
+    // Called with the live count of the kind that went over the threshold, and the tag of the reference
+    // that did it. It runs on the thread creating the reference and must not create references itself.
+    typedef void (*RefThresholdCallback)(RefKind kind, int64_t live, const char *tag);
+
+    // Optional accounting of the references natiflect creates and deletes, off by default. Each reference
+    // is recorded under a tag naming where it was created, which must be a string literal. Local
+    // references released by DeleteLocalRef(), by popping a local frame, by returning from a native
+    // method inside a LocalScope, or by the thread exiting are accounted as deleted. Since the return of
+    // other native methods cannot be observed, only the most recent local references of each thread are
+    // tracked, and older ones are accounted as deleted.
+    class RefMonitor {
+    public:
+        static void SetEnabled(bool enabled);
+
+        static bool IsEnabled() { return enabled_.load(memory_order_relaxed); };
+
+        static void OnCreate(RefKind kind, jobject ref, const char *tag) {
+            if (ref && IsEnabled()) {
+                Record(kind, ref, tag, 1);
+            }
+        };
+
+        static void OnDelete(RefKind kind, jobject ref, const char *tag) {
+            if (ref && IsEnabled()) {
+                Record(kind, ref, tag, -1);
+            }
+        };
+
+        // Deletes a local reference natiflect returned, accounting for it.
+        static void DeleteLocalRef(JNIEnv *env, jobject ref) {
+            OnDelete(kLocalRef, ref, NULL);
+            env->DeleteLocalRef(ref);
+        };
+
+        // Returns the local reference count of the current thread, to be passed to LeaveFrame when all
+        // local references created since have been released.
+        static int64_t EnterFrame();
+
+        static void LeaveFrame(int64_t saved);
+
+        static RefCounts GetCounts(RefKind kind);
+
+        static RefCounts GetThreadCounts(RefKind kind);
+
+        // Tags that still own references: global and weak global references of the process, and local
+        // references of the current thread.
+        static vector<RefLeak> GetLeakReport();
+
+        // Calls callback whenever the live count of kind rises above threshold (per thread for local
+        // references, whose threshold must be below the 1024 tracked). A threshold of 0 disables it.
+        static void SetThreshold(RefKind kind, int64_t threshold, RefThresholdCallback callback);
+
+        // Counts the local references natiflect creates in a native method as released when it returns.
+        class LocalScope {
+        public:
+            LocalScope() : saved_(EnterFrame()) { };
+
+            ~LocalScope() { LeaveFrame(saved_); };
+
+        private:
+            LocalScope(const LocalScope &);
+
+            LocalScope &operator=(const LocalScope &);
+
+            int64_t saved_;
+        };
+
+    private:
+        static void Record(RefKind kind, jobject ref, const char *tag, int64_t delta);
+
+        static atomic<bool> enabled_;
+    };
+}
+
+#endif //NATIFLECT_REF_MONITOR_H
@@ -0,0 +1,157 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "string_pool.h"
+
+#include <string.h>
+
+#include "exception.h"
+#include "ref_monitor.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        const size_t kDefaultStringPoolCapacity = 256 << 10;
+
+        // Rough overhead of a map node and the Java string on top of the characters.
+        const size_t kEntryOverhead = 96;
+    }
+
+    StringPool::StringPool() {
+        memset(&stats_, 0, sizeof(stats_));
+        stats_.capacity = kDefaultStringPoolCapacity;
+    }
+
+    StringPool &StringPool::GetInstance() {
+        static StringPool instance;
+        return instance;
+    }
+
+    jstring StringPool::Intern(JNIEnv *env, const char *value) {
+        if (!value) {
+            return NULL;
+        }
+        return Intern(env, value, HashMember(value, ""));
+    }
+
+    jstring StringPool::Intern(JNIEnv *env, const char *value, uint64_t hash) {
+        if (!value) {
+            return NULL;
+        }
+        jstring result = TryIntern(env, value, hash);
+        if (!result) {
+            throw Exception(string("Cannot intern string \"") + value + "\", because the string pool is full.");
+        }
+        return result;
+    }
+
+    jstring StringPool::GetLocal(JNIEnv *env, const char *value) {
+        if (!value) {
+            return NULL;
+        }
+        jstring interned = TryIntern(env, value, HashMember(value, ""));
+        jstring result = interned ? (jstring) env->NewLocalRef(interned) : env->NewStringUTF(value);
+        if (!result) {
+            env->ExceptionClear();
+            throw Exception(string("Cannot create string \"") + value + "\".");
+        }
+        RefMonitor::OnCreate(kLocalRef, result, "StringPool::GetLocal");
+        return result;
+    }
+
+    jstring StringPool::TryIntern(JNIEnv *env, const char *value, uint64_t hash) {
+        size_t bytes = sizeof(Entry) + strlen(value) * 3 + kEntryOverhead;
+        {
+            lock_guard<mutex> lock(mutex_);
+            pair<EntryMap::iterator, EntryMap::iterator> range = entries_.equal_range(hash);
+            for (EntryMap::iterator it = range.first; it != range.second; ++it) {
+                if (it->second.value_address == (uintptr_t) value || it->second.value == value) {
+                    stats_.hits++;
+                    return it->second.ref;
+                }
+            }
+            stats_.misses++;
+            if (stats_.bytes + bytes > stats_.capacity) {
+                return NULL;
+            }
+        }
+
+        jstring local = env->NewStringUTF(value);
+        if (!local) {
+            env->ExceptionClear();
+            throw Exception(string("Cannot create string \"") + value + "\".");
+        }
+        jstring global = (jstring) env->NewGlobalRef(local);
+        env->DeleteLocalRef(local);
+        if (!global) {
+            throw Exception(string("Cannot create a global reference to string \"") + value + "\".");
+        }
+        RefMonitor::OnCreate(kGlobalRef, global, "StringPool");
+
+        lock_guard<mutex> lock(mutex_);
+        pair<EntryMap::iterator, EntryMap::iterator> range = entries_.equal_range(hash);
+        for (EntryMap::iterator it = range.first; it != range.second; ++it) {
+            if (it->second.value == value) {
+                // Another thread got here first.
+                RefMonitor::OnDelete(kGlobalRef, global, "StringPool");
+                env->DeleteGlobalRef(global);
+                return it->second.ref;
+            }
+        }
+        if (stats_.bytes + bytes > stats_.capacity) {
+            // Other threads used up the capacity meanwhile.
+            RefMonitor::OnDelete(kGlobalRef, global, "StringPool");
+            env->DeleteGlobalRef(global);
+            return NULL;
+        }
+        Entry entry;
+        entry.value = value;
+        entry.value_address = (uintptr_t) value;
+        entry.ref = global;
+        entries_.insert(make_pair(hash, entry));
+        stats_.entries++;
+        stats_.bytes += bytes;
+        return global;
+    }
+
+    CacheStats StringPool::GetStats() {
+        lock_guard<mutex> lock(mutex_);
+        return stats_;
+    }
+
+    void StringPool::SetCapacity(size_t capacity) {
+        lock_guard<mutex> lock(mutex_);
+        stats_.capacity = capacity;
+    }
+
+    void StringPool::Clear(JNIEnv *env) {
+        lock_guard<mutex> lock(mutex_);
+        for (EntryMap::iterator it = entries_.begin(); it != entries_.end(); ++it) {
+            RefMonitor::OnDelete(kGlobalRef, it->second.ref, "StringPool");
+            env->DeleteGlobalRef(it->second.ref);
+        }
+        entries_.clear();
+        stats_.entries = 0;
+        stats_.bytes = 0;
+    }
+}
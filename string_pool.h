@@ -0,0 +1,92 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_STRING_POOL_H
+#define NATIFLECT_STRING_POOL_H
+
+#include <jni.h>
+#include <stdint.h>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+#include "cache.h"
+#include "member_key.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    // Interns constant strings into global jstring references, so that passing the same constant to Java
+    // again costs neither an allocation nor a UTF decode. Since interned strings are handed out and may
+    // be held anywhere, they are never evicted; once the capacity is used up, nothing more is interned.
+    // Strings are in modified UTF-8, as for NewStringUTF. Use NF_STRING for literals.
+    class StringPool {
+    public:
+        static StringPool &GetInstance();
+
+        // Returns a global reference owned by the pool, which must not be deleted. Throws Exception if the
+        // string is new and the pool is full. Returns NULL with no exception pending only if value is NULL.
+        jstring Intern(JNIEnv *env, const char *value);
+
+        jstring Intern(JNIEnv *env, const char *value, uint64_t hash);
+
+        // Returns a new local reference owned by the caller: to the interned string while there is room,
+        // or to a new string once the pool is full. For strings that may not be constant.
+        jstring GetLocal(JNIEnv *env, const char *value);
+
+        // Hits and misses count lookups, including those of strings refused because the pool is full.
+        // Evictions are always 0.
+        CacheStats GetStats();
+
+        // Only affects strings interned from now on.
+        void SetCapacity(size_t capacity);
+
+        // Deletes all interned strings. Only safe when none of them is still in use.
+        void Clear(JNIEnv *env);
+
+    private:
+        StringPool();
+
+        // Returns NULL if the string is new and the pool is full.
+        jstring TryIntern(JNIEnv *env, const char *value, uint64_t hash);
+
+        struct Entry {
+            string value;
+            // See WeakRefCache::Entry.
+            uintptr_t value_address;
+            jstring ref;
+        };
+
+        typedef unordered_multimap<uint64_t, Entry> EntryMap;
+
+        mutex mutex_;
+        EntryMap entries_;
+        CacheStats stats_;
+    };
+}
+
+#define NF_STRING(env, str) \
+    (::natiflect::StringPool::GetInstance().Intern((env), (str), \
+        ::std::integral_constant<uint64_t, ::natiflect::ConstHashMember((str), "")>::value))
+
+#endif //NATIFLECT_STRING_POOL_H
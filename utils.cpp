@@ -25,6 +25,9 @@
 #include "utils.h"
 
 #include "exception.h"
+#include "cache.h"
+#include "ref_monitor.h"
+#include "warmup.h"
 
 namespace natiflect {
 
@@ -35,8 +38,14 @@ namespace natiflect {
         }
     }
 
-    jmethodID GetMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static) {
-        jmethodID method_id;
+    static jmethodID GetMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                                 uint64_t hash) {
+        MemberCache &cache = MemberCache::GetInstance();
+        jmethodID method_id = cache.FindMethodID(env, clz, name, sig, is_static, hash);
+        if (method_id) {
+            return method_id;
+        }
+
         if (is_static) {
             method_id = env->GetStaticMethodID(clz, name, sig);
         } else {
@@ -47,9 +56,19 @@ namespace natiflect {
             throw NotFoundException(string("Cannot find") + (is_static ? " static " : " ") + "method \""
                                     + name + "\" with signature \"" + sig + "\".");
         }
+        cache.PutMethodID(env, clz, name, sig, is_static, hash, method_id);
+        Warmup::OnMemberResolved(env, is_static ? 'S' : 'M', clz, name, sig);
         return method_id;
     }
 
+    jmethodID GetMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static) {
+        return GetMethodID(env, clz, name, sig, is_static, HashMember(name, sig));
+    }
+
+    jmethodID GetMethodID(JNIEnv *env, jclass clz, const MemberKey &key, bool is_static) {
+        return GetMethodID(env, clz, key.name, key.sig, is_static, key.hash);
+    }
+
     void CheckCallMethodException(JNIEnv *env, const char *name, const char *sig, bool is_static) {
         if (env->ExceptionCheck()) {
             env->ExceptionClear();
@@ -58,8 +77,14 @@ namespace natiflect {
         }
     }
 
-    jfieldID GetFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static) {
-        jfieldID field_id;
+    static jfieldID GetFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static,
+                               uint64_t hash) {
+        MemberCache &cache = MemberCache::GetInstance();
+        jfieldID field_id = cache.FindFieldID(env, clz, name, sig, is_static, hash);
+        if (field_id) {
+            return field_id;
+        }
+
         if (is_static) {
             field_id = env->GetStaticFieldID(clz, name, sig);
         } else {
@@ -70,9 +95,19 @@ namespace natiflect {
             throw NotFoundException(string("Cannot find") + (is_static ? " static " : " ") + "field \""
                                     + name + "\" with signature \"" + sig + "\".");
         }
+        cache.PutFieldID(env, clz, name, sig, is_static, hash, field_id);
+        Warmup::OnMemberResolved(env, is_static ? 'G' : 'F', clz, name, sig);
         return field_id;
     }
 
+    jfieldID GetFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static) {
+        return GetFieldID(env, clz, name, sig, is_static, HashMember(name, sig));
+    }
+
+    jfieldID GetFieldID(JNIEnv *env, jclass clz, const MemberKey &key, bool is_static) {
+        return GetFieldID(env, clz, key.name, key.sig, is_static, key.hash);
+    }
+
     void CheckAccessFieldException(JNIEnv *env, const char *name, const char *sig, bool is_static) {
         if (env->ExceptionCheck()) {
             env->ExceptionClear();
@@ -80,4 +115,165 @@ namespace natiflect {
                                   + name + "\" with signature \"" + sig + "\" failed.");
         }
     }
+
+    LocalFrame::LocalFrame(JNIEnv *env, jint capacity) {
+        env_ = env;
+        popped_ = false;
+        if (env_->PushLocalFrame(capacity) < 0) {
+            env_->ExceptionClear();
+            popped_ = true;
+            throw Exception("Cannot push a local frame.");
+        }
+        saved_local_refs_ = RefMonitor::EnterFrame();
+    }
+
+    LocalFrame::~LocalFrame() {
+        Pop();
+    }
+
+    jobject LocalFrame::Pop(jobject result) {
+        if (popped_) {
+            return result;
+        }
+        popped_ = true;
+        result = env_->PopLocalFrame(result);
+        RefMonitor::LeaveFrame(saved_local_refs_);
+        RefMonitor::OnCreate(kLocalRef, result, "LocalFrame::Pop");
+        return result;
+    }
+
+    JNIEnv *GetAttachedEnv(JavaVM *vm) {
+        JNIEnv *env = NULL;
+        if (!vm || vm->GetEnv((void **) &env, JNI_VERSION_1_6) != JNI_OK) {
+            return NULL;
+        }
+        return env;
+    }
+
+    namespace {
+
+        // Skips one field type starting at sig, returning the character after it, or NULL if malformed.
+        const char *SkipFieldType(const char *sig) {
+            while (*sig == '[') {
+                sig++;
+            }
+            switch (*sig) {
+                case 'Z':
+                case 'B':
+                case 'C':
+                case 'S':
+                case 'I':
+                case 'J':
+                case 'F':
+                case 'D':
+                    return sig + 1;
+                case 'L': {
+                    const char *end = sig + 1;
+                    while (*end && *end != ';') {
+                        end++;
+                    }
+                    return *end == ';' && end > sig + 1 ? end + 1 : NULL;
+                }
+                default:
+                    return NULL;
+            }
+        }
+    }
+
+    bool ParseMethodSignature(const char *sig, string *param_types, char *return_type) {
+        if (*sig != '(') {
+            return false;
+        }
+        sig++;
+        param_types->clear();
+        while (*sig != ')') {
+            const char *next = SkipFieldType(sig);
+            if (!next) {
+                return false;
+            }
+            param_types->push_back(*sig == '[' ? 'L' : *sig);
+            sig = next;
+        }
+        sig++;
+        if (*sig == 'V' && sig[1] == '\0') {
+            *return_type = 'V';
+            return true;
+        }
+        const char *end = SkipFieldType(sig);
+        if (!end || *end != '\0') {
+            return false;
+        }
+        *return_type = *sig == '[' ? 'L' : *sig;
+        return true;
+    }
+
+    uint64_t HashMember(const char *name, const char *sig) {
+        // FNV-1a over name, a zero separator and sig.
+        uint64_t hash = 14695981039346656037ULL;
+        for (const char *p = name; *p; p++) {
+            hash = (hash ^ (unsigned char) *p) * 1099511628211ULL;
+        }
+        hash *= 1099511628211ULL;
+        for (const char *p = sig; *p; p++) {
+            hash = (hash ^ (unsigned char) *p) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    string GetStringUTF(JNIEnv *env, jstring str) {
+        if (!str) {
+            return string();
+        }
+        const char *chars = env->GetStringUTFChars(str, NULL);
+        if (!chars) {
+            env->ExceptionClear();
+            throw AccessException("Cannot get characters of the string.");
+        }
+        string result(chars);
+        env->ReleaseStringUTFChars(str, chars);
+        return result;
+    }
+
+    string GetClassName(JNIEnv *env, jclass clz) {
+        jclass clz_class = env->GetObjectClass(clz);
+        jmethodID get_name = GetMethodID(env, clz_class, "getName", "()Ljava/lang/String;");
+        jstring name = (jstring) env->CallObjectMethod(clz, get_name);
+        env->DeleteLocalRef(clz_class);
+        CheckCallMethodException(env, "getName", "()Ljava/lang/String;");
+        string result = GetStringUTF(env, name);
+        env->DeleteLocalRef(name);
+        return result;
+    }
+
+    string GetTypeSignature(const string &class_name) {
+        // Turns a name returned by Class.getName() into a JNI type signature,
+        // e.g. "int" -> "I", "java.lang.String" -> "Ljava/lang/String;", "[I" -> "[I".
+        static const char *const primitives[][2] = {
+                {"void",    "V"},
+                {"boolean", "Z"},
+                {"byte",    "B"},
+                {"char",    "C"},
+                {"short",   "S"},
+                {"int",     "I"},
+                {"long",    "J"},
+                {"float",   "F"},
+                {"double",  "D"}
+        };
+        for (size_t i = 0; i < sizeof(primitives) / sizeof(primitives[0]); i++) {
+            if (class_name == primitives[i][0]) {
+                return primitives[i][1];
+            }
+        }
+
+        string result = class_name;
+        for (size_t i = 0; i < result.size(); i++) {
+            if (result[i] == '.') {
+                result[i] = '/';
+            }
+        }
+        if (!result.empty() && result[0] == '[') {
+            return result;
+        }
+        return "L" + result + ";";
+    }
 }
@@ -26,8 +26,11 @@
 #define NATIFLECT_UTILS_H
 
 #include <jni.h>
+#include <stdint.h>
 #include <string>
 
+#include "member_key.h"
+
 using namespace std;
 
 namespace natiflect {
@@ -36,11 +39,60 @@ namespace natiflect {
 
     jmethodID GetMethodID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static = false);
 
+    jmethodID GetMethodID(JNIEnv *env, jclass clz, const MemberKey &key, bool is_static = false);
+
     void CheckCallMethodException(JNIEnv *env, const char *name, const char *sig, bool is_static = false);
 
     jfieldID GetFieldID(JNIEnv *env, jclass clz, const char *name, const char *sig, bool is_static = false);
 
+    jfieldID GetFieldID(JNIEnv *env, jclass clz, const MemberKey &key, bool is_static = false);
+
     void CheckAccessFieldException(JNIEnv *env, const char *name, const char *sig, bool is_static = false);
+
+    class LocalFrame {
+    public:
+        LocalFrame(JNIEnv *env, jint capacity);
+
+        ~LocalFrame();
+
+        jobject Pop(jobject result = NULL);
+
+    private:
+        LocalFrame(const LocalFrame &);
+
+        LocalFrame &operator=(const LocalFrame &);
+
+        JNIEnv *env_;
+        bool popped_;
+        int64_t saved_local_refs_;
+    };
+
+    template<typename R>
+    R UnboxLocalRef(JNIEnv *env, jobject box, R (*unbox)(JNIEnv *, jobject)) {
+        try {
+            R result = unbox(env, box);
+            env->DeleteLocalRef(box);
+            return result;
+        } catch (...) {
+            env->DeleteLocalRef(box);
+            throw;
+        }
+    }
+
+    // Returns the JNIEnv of the current thread, or NULL if it is not attached to the VM.
+    JNIEnv *GetAttachedEnv(JavaVM *vm);
+
+    // Splits a method signature into one type character per parameter ('L' for objects and arrays)
+    // and the return type character. Returns false if the signature is malformed.
+    bool ParseMethodSignature(const char *sig, string *param_types, char *return_type);
+
+    uint64_t HashMember(const char *name, const char *sig);
+
+    string GetStringUTF(JNIEnv *env, jstring str);
+
+    string GetClassName(JNIEnv *env, jclass clz);
+
+    string GetTypeSignature(const string &class_name);
 }
 
 #endif //NATIFLECT_UTILS_H
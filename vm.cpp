@@ -0,0 +1,219 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "vm.h"
+
+#include <dlfcn.h>
+#include <stdlib.h>
+#include <chrono>
+
+namespace natiflect {
+
+    namespace {
+
+        typedef jint (*CreateJavaVMFunc)(JavaVM **, void **, void *);
+
+        typedef jint (*GetCreatedJavaVMsFunc)(JavaVM **, jsize, jsize *);
+
+#if defined(__APPLE__)
+        const char *const kLibraryName = "libjvm.dylib";
+#else
+        const char *const kLibraryName = "libjvm.so";
+#endif
+
+#if defined(_WIN32)
+        const char kPathSeparator = ';';
+#else
+        const char kPathSeparator = ':';
+#endif
+
+        atomic<JavaVM *> current_vm(NULL);
+        atomic<int64_t> start_ns(0);
+        atomic<int64_t> first_call_ns(-1);
+
+        int64_t NowNanos() {
+            return chrono::duration_cast<chrono::nanoseconds>(
+                    chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        void *FindSymbol(const string &library_path, const char *name) {
+            if (library_path.empty()) {
+                void *symbol = dlsym(RTLD_DEFAULT, name);
+                if (symbol) {
+                    return symbol;
+                }
+            }
+
+            vector<string> candidates;
+            if (!library_path.empty()) {
+                candidates.push_back(library_path);
+            } else {
+                candidates.push_back(kLibraryName);
+                const char *java_home = getenv("JAVA_HOME");
+                if (java_home) {
+                    candidates.push_back(string(java_home) + "/lib/server/" + kLibraryName);
+                    candidates.push_back(string(java_home) + "/jre/lib/server/" + kLibraryName);
+                }
+            }
+            for (size_t i = 0; i < candidates.size(); i++) {
+                void *handle = dlopen(candidates[i].c_str(), RTLD_NOW | RTLD_GLOBAL);
+                if (handle) {
+                    return dlsym(handle, name);
+                }
+            }
+            return NULL;
+        }
+
+        vector<string> BuildOptionStrings(const VmOptions &options) {
+            vector<string> result;
+            if (!options.classpath.empty()) {
+                string classpath = "-Djava.class.path=";
+                for (size_t i = 0; i < options.classpath.size(); i++) {
+                    if (i > 0) {
+                        classpath += kPathSeparator;
+                    }
+                    classpath += options.classpath[i];
+                }
+                result.push_back(classpath);
+            }
+            if (!options.initial_heap.empty()) {
+                result.push_back("-Xms" + options.initial_heap);
+            }
+            if (!options.max_heap.empty()) {
+                result.push_back("-Xmx" + options.max_heap);
+            }
+            if (!options.shared_archive.empty()) {
+                result.push_back("-XX:SharedArchiveFile=" + options.shared_archive);
+                result.push_back(options.require_shared_archive ? "-Xshare:on" : "-Xshare:auto");
+            }
+            switch (options.jit_mode) {
+                case VmOptions::kJitQuickStart:
+                    result.push_back("-XX:TieredStopAtLevel=1");
+                    break;
+                case VmOptions::kJitInterpretedOnly:
+                    result.push_back("-Xint");
+                    break;
+                default:
+                    break;
+            }
+            result.insert(result.end(), options.extra_options.begin(), options.extra_options.end());
+            return result;
+        }
+    }
+
+    atomic<bool> Vm::first_call_pending_(false);
+
+#pragma mark - Public
+
+    Vm::Vm(const VmOptions &options) {
+        version_ = options.version;
+        created_ = false;
+        int64_t start = NowNanos();
+
+        GetCreatedJavaVMsFunc get_created = (GetCreatedJavaVMsFunc) FindSymbol(options.library_path,
+                                                                               "JNI_GetCreatedJavaVMs");
+        CreateJavaVMFunc create = (CreateJavaVMFunc) FindSymbol(options.library_path, "JNI_CreateJavaVM");
+        if (!get_created || !create) {
+            throw NotFoundException("Cannot find the JVM library.");
+        }
+
+        jsize count = 0;
+        vm_ = NULL;
+        if (get_created(&vm_, 1, &count) != JNI_OK || count == 0) {
+            vector<string> option_strings = BuildOptionStrings(options);
+            vector<JavaVMOption> vm_options(option_strings.size());
+            for (size_t i = 0; i < option_strings.size(); i++) {
+                vm_options[i].optionString = const_cast<char *>(option_strings[i].c_str());
+                vm_options[i].extraInfo = NULL;
+            }
+            JavaVMInitArgs args;
+            args.version = version_;
+            args.nOptions = (jint) vm_options.size();
+            args.options = vm_options.empty() ? NULL : &vm_options[0];
+            args.ignoreUnrecognized = options.ignore_unrecognized ? JNI_TRUE : JNI_FALSE;
+
+            JNIEnv *env = NULL;
+            jint result = create(&vm_, (void **) &env, &args);
+            if (result != JNI_OK) {
+                vm_ = NULL;
+                throw Exception("Cannot create the JVM, error " + to_string(result) + ".");
+            }
+            created_ = true;
+        }
+
+        int64_t end = NowNanos();
+        create_ms_ = (end - start) / 1e6;
+        start_ns.store(start);
+        first_call_ns.store(-1);
+        first_call_pending_.store(true);
+        SetCurrentJavaVM(vm_);
+    }
+
+    Vm::~Vm() {
+        if (current_vm.load() == vm_) {
+            current_vm.store(NULL);
+        }
+        if (created_ && vm_) {
+            vm_->DestroyJavaVM();
+        }
+    }
+
+    JNIEnv *Vm::GetEnv() {
+        JNIEnv *env = NULL;
+        jint result = vm_->GetEnv((void **) &env, version_);
+        if (result == JNI_EDETACHED) {
+            result = vm_->AttachCurrentThread((void **) &env, NULL);
+        }
+        if (result != JNI_OK) {
+            throw Exception("Cannot get the JNIEnv of the current thread, error " + to_string(result) + ".");
+        }
+        return env;
+    }
+
+    void Vm::DetachCurrentThread() {
+        vm_->DetachCurrentThread();
+    }
+
+    VmStartupReport Vm::GetStartupReport() {
+        VmStartupReport report;
+        report.created = created_;
+        report.create_ms = create_ms_;
+        int64_t first_call = first_call_ns.load();
+        report.first_call_ms = first_call < 0 ? -1 : (first_call - start_ns.load()) / 1e6;
+        return report;
+    }
+
+    JavaVM *Vm::GetCurrentJavaVM() {
+        return current_vm.load();
+    }
+
+    void Vm::SetCurrentJavaVM(JavaVM *vm) {
+        current_vm.store(vm);
+    }
+
+#pragma mark - Private
+
+    void Vm::RecordFirstCall() {
+        if (first_call_pending_.exchange(false)) {
+            first_call_ns.store(NowNanos());
+        }
+    }
+}
@@ -0,0 +1,124 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_VM_H
+#define NATIFLECT_VM_H
+
+#include <jni.h>
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "exception.h"
+
+using namespace std;
+
+namespace natiflect {
+
+    struct VmOptions {
+        enum JitMode {
+            // Leave the JIT configuration to the VM.
+            kJitDefault,
+            // Stop tiered compilation at C1 (-XX:TieredStopAtLevel=1), which shortens warm-up.
+            kJitQuickStart,
+            // Interpret only (-Xint).
+            kJitInterpretedOnly
+        };
+
+        VmOptions() : version(JNI_VERSION_1_6), require_shared_archive(false), jit_mode(kJitDefault),
+                      ignore_unrecognized(false) { };
+
+        jint version;
+        // Path of the JVM library. If empty, a JNI_CreateJavaVM already linked into the process is used,
+        // then the library is looked up by its default name and under $JAVA_HOME.
+        string library_path;
+        vector<string> classpath;
+        // Heap sizes in -Xms/-Xmx syntax, e.g. "256m". Empty leaves the VM default.
+        string initial_heap;
+        string max_heap;
+        // CDS/AppCDS archive to map at startup.
+        string shared_archive;
+        // Fail instead of silently running without the archive when it cannot be mapped.
+        bool require_shared_archive;
+        JitMode jit_mode;
+        // Passed to the VM as is, after the typed options.
+        vector<string> extra_options;
+        bool ignore_unrecognized;
+    };
+
+    struct VmStartupReport {
+        // Whether the VM was created by natiflect rather than joined.
+        bool created;
+        // Time spent creating or joining the VM.
+        double create_ms;
+        // Time from the start of creating or joining the VM to the first Java call made through Object or
+        // Class, or -1 if there has not been one yet. Calls natiflect makes internally do not count.
+        double first_call_ms;
+    };
+
+    // Creates or joins the JVM of the process. Joining happens when a VM already exists, e.g. when
+    // natiflect is loaded by Java. A VM created here is destroyed with this object; note that
+    // a JVM cannot be created again in the same process after that.
+    class Vm {
+    public:
+        explicit Vm(const VmOptions &options = VmOptions());
+
+        ~Vm();
+
+        JavaVM *GetJavaVM() { return vm_; };
+
+        // Returns the JNIEnv of the current thread, attaching it if needed.
+        JNIEnv *GetEnv();
+
+        void DetachCurrentThread();
+
+        VmStartupReport GetStartupReport();
+
+        // The VM natiflect works with, set by the last created or joined Vm, or by SetCurrentJavaVM().
+        static JavaVM *GetCurrentJavaVM();
+
+        // Lets libraries loaded by Java hand their VM to natiflect, typically from JNI_OnLoad.
+        static void SetCurrentJavaVM(JavaVM *vm);
+
+        // Called after each successful call through the public Call and NewInstance methods.
+        static void OnCall() {
+            if (first_call_pending_.load(memory_order_relaxed)) {
+                RecordFirstCall();
+            }
+        }
+
+    private:
+        Vm(const Vm &);
+
+        Vm &operator=(const Vm &);
+
+        static void RecordFirstCall();
+
+        static atomic<bool> first_call_pending_;
+
+        JavaVM *vm_;
+        jint version_;
+        bool created_;
+        double create_ms_;
+    };
+}
+
+#endif //NATIFLECT_VM_H
@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "warmup.h"
+
+#include <stdio.h>
+#include <condition_variable>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
+
+#include "exception.h"
+#include "class.h"
+#include "utils.h"
+
+namespace natiflect {
+
+    namespace {
+
+        mutex record_mutex;
+        FILE *record_file = NULL;
+        unordered_set<string> recorded;
+
+        // Set while recording on this thread, so that looking up the class name does not record itself.
+        thread_local bool in_record = false;
+
+        // The replay thread is detached, so that none is left to join at exit, and publishes its
+        // result here.
+        struct ReplayState {
+            ReplayState() : running(false), count(0) { };
+
+            mutex mutex_;
+            condition_variable done;
+            bool running;
+            size_t count;
+        };
+
+        // Never deleted, so that a replay thread still running while the process exits does not use
+        // destroyed statics.
+        ReplayState &GetReplayState() {
+            static ReplayState *state = new ReplayState;
+            return *state;
+        }
+
+        string ToInternalName(const string &class_name) {
+            string result = class_name;
+            for (size_t i = 0; i < result.size(); i++) {
+                if (result[i] == '.') {
+                    result[i] = '/';
+                }
+            }
+            return result;
+        }
+
+        bool ReplayLine(JNIEnv *env, const string &line) {
+            istringstream in(line);
+            string kind, class_name, name, sig;
+            in >> kind >> class_name;
+            if (kind.size() != 1 || class_name.empty()) {
+                return false;
+            }
+
+            LocalFrame frame(env, 4);
+            try {
+                Class clz(env, class_name.c_str());
+                switch (kind[0]) {
+                    case 'C':
+                        return true;
+                    case 'M':
+                    case 'S':
+                        in >> name >> sig;
+                        GetMethodID(env, clz.GetJClass(), name.c_str(), sig.c_str(), kind[0] == 'S');
+                        return true;
+                    case 'F':
+                    case 'G':
+                        in >> name >> sig;
+                        GetFieldID(env, clz.GetJClass(), name.c_str(), sig.c_str(), kind[0] == 'G');
+                        return true;
+                    default:
+                        return false;
+                }
+            } catch (const Exception &) {
+                return false;
+            }
+        }
+    }
+
+    atomic<bool> Warmup::recording_(false);
+
+#pragma mark - Record
+
+    void Warmup::StartRecording(const string &path) {
+        lock_guard<mutex> lock(record_mutex);
+        if (record_file) {
+            fclose(record_file);
+        }
+        record_file = fopen(path.c_str(), "w");
+        if (!record_file) {
+            throw Exception("Cannot open \"" + path + "\" for recording.");
+        }
+        recorded.clear();
+        recording_.store(true);
+    }
+
+    void Warmup::StopRecording() {
+        lock_guard<mutex> lock(record_mutex);
+        recording_.store(false);
+        if (record_file) {
+            fclose(record_file);
+            record_file = NULL;
+        }
+        recorded.clear();
+    }
+
+    void Warmup::Record(JNIEnv *env, char kind, jclass clz, const char *name, const char *sig) {
+        if (in_record) {
+            return;
+        }
+        in_record = true;
+        string line(1, kind);
+        try {
+            if (clz) {
+                line += " " + ToInternalName(GetClassName(env, clz)) + " " + name + " " + sig;
+            } else {
+                line += string(" ") + name;
+            }
+        } catch (const Exception &) {
+            in_record = false;
+            return;
+        }
+        in_record = false;
+
+        lock_guard<mutex> lock(record_mutex);
+        if (record_file && recorded.insert(line).second) {
+            // Written through right away, so that a manifest survives a process that never stops recording.
+            fputs((line + "\n").c_str(), record_file);
+            fflush(record_file);
+        }
+    }
+
+#pragma mark - Replay
+
+    size_t Warmup::Replay(JNIEnv *env, const string &path) {
+        ifstream in(path.c_str());
+        if (!in) {
+            throw Exception("Cannot open \"" + path + "\" for replaying.");
+        }
+        size_t count = 0;
+        string line;
+        while (getline(in, line)) {
+            if (!line.empty() && ReplayLine(env, line)) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+    void Warmup::ReplayInBackground(JavaVM *vm, const string &path) {
+        ReplayState *state = &GetReplayState();
+        unique_lock<mutex> lock(state->mutex_);
+        state->done.wait(lock, [state]() { return !state->running; });
+        state->running = true;
+        state->count = 0;
+        try {
+            thread([vm, path, state]() {
+                size_t count = 0;
+                JNIEnv *env = NULL;
+                JavaVMAttachArgs args;
+                args.version = JNI_VERSION_1_6;
+                args.name = const_cast<char *>("natiflect-warmup");
+                args.group = NULL;
+                if (vm->AttachCurrentThreadAsDaemon((void **) &env, &args) == JNI_OK) {
+                    try {
+                        count = Replay(env, path);
+                    } catch (...) {
+                    }
+                    vm->DetachCurrentThread();
+                }
+                lock_guard<mutex> done_lock(state->mutex_);
+                state->count = count;
+                state->running = false;
+                state->done.notify_all();
+            }).detach();
+        } catch (...) {
+            state->running = false;
+            throw;
+        }
+    }
+
+    size_t Warmup::WaitForReplay() {
+        ReplayState *state = &GetReplayState();
+        unique_lock<mutex> lock(state->mutex_);
+        state->done.wait(lock, [state]() { return !state->running; });
+        return state->count;
+    }
+}
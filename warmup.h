@@ -0,0 +1,75 @@
+//
+// Copyright (c) 2016 Richard Chien
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy of
+// this software and associated documentation files (the "Software"), to deal in
+// the Software without restriction, including without limitation the rights to
+// use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+// the Software, and to permit persons to whom the Software is furnished to do so,
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+// FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+// COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+// IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+// CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#ifndef NATIFLECT_WARMUP_H
+#define NATIFLECT_WARMUP_H
+
+#include <jni.h>
+#include <atomic>
+#include <string>
+
+using namespace std;
+
+namespace natiflect {
+
+    // Records the classes and members natiflect resolves into a manifest file, and replays such a manifest
+    // at startup to fill the caches before the first real lookups. Replaying initializes the classes
+    // involved, as the first real lookup would. Entries that cannot be resolved are skipped.
+    //
+    // The manifest has one entry per line: "C <class>", or "<kind> <class> <name> <sig>" where kind is
+    // M (method), S (static method), F (field) or G (static field). Class names use the JNI form.
+    class Warmup {
+    public:
+        static void StartRecording(const string &path);
+
+        static void StopRecording();
+
+        // Resolves all entries of the manifest on the current thread, e.g. from JNI_OnLoad.
+        // Returns the number of entries resolved.
+        static size_t Replay(JNIEnv *env, const string &path);
+
+        // Replays the manifest on a detached daemon thread attached to the VM, after any replay already
+        // running is done. Call WaitForReplay before unloading the library.
+        static void ReplayInBackground(JavaVM *vm, const string &path);
+
+        // Waits for the background replay, if any, and returns the number of entries it resolved.
+        static size_t WaitForReplay();
+
+        static void OnClassFound(JNIEnv *env, const char *name) {
+            if (recording_.load(memory_order_relaxed)) {
+                Record(env, 'C', NULL, name, NULL);
+            }
+        }
+
+        static void OnMemberResolved(JNIEnv *env, char kind, jclass clz, const char *name, const char *sig) {
+            if (recording_.load(memory_order_relaxed)) {
+                Record(env, kind, clz, name, sig);
+            }
+        }
+
+    private:
+        static void Record(JNIEnv *env, char kind, jclass clz, const char *name, const char *sig);
+
+        static atomic<bool> recording_;
+    };
+}
+
+#endif //NATIFLECT_WARMUP_H